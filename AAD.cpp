@@ -0,0 +1,32 @@
+#include "AAD.hpp"
+
+void Tape::rewind()
+{
+	this->nodes.clear();
+}
+
+long Tape::size() const
+{
+	return static_cast<long>(this->nodes.size());
+}
+
+void Tape::backward(long result)
+{
+	// Adjoint of node i: derivative of the result wrt node i. Each node passes its adjoint
+	// on to the nodes it was made from, in reverse order, so every adjoint is complete
+	// before it is passed on
+	this->adjoints.assign(this->nodes.size(), 0.0);
+	this->adjoints[result] = 1.0;
+	for (long i = result; i >= 0; --i)
+	{
+		const Node& node = this->nodes[i];
+		double adjoint = this->adjoints[i];
+		this->adjoints[node.first] += node.firstPartial * adjoint;
+		this->adjoints[node.second] += node.secondPartial * adjoint;
+	}
+}
+
+double Tape::adjoint(long node) const
+{
+	return this->adjoints[node];
+}
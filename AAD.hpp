@@ -0,0 +1,140 @@
+#ifndef AAD_HPP
+#define AAD_HPP
+
+// Built-in header files
+#include <vector>
+#include <cmath>
+
+/* ABOUT
+	- Adjoint algorithmic differentiation (reverse mode) with a tape
+	- A Number is a double that records every operation done with it on the tape of its thread:
+	  each node keeps the (up to two) nodes it was made from and the partial derivatives wrt them
+	- After the calculation, Tape::backward(result) goes through the nodes once in reverse order and
+	  gives the derivative of the result wrt every number on the tape, so all the sensitivities
+	  of one result cost one backward sweep, however many inputs there are
+	- The tape is meant to be rewound (Tape::rewind) after each path, so it only holds one path and
+	  stays in the cache. Every thread has its own tape, so paths can be run on several threads*/
+
+class Tape
+{
+private:
+	// Node: made from nodes first and second, with partial derivatives firstPartial and secondPartial.
+	// Inputs and constants point at themselves with zero partials, so the sweep has no branches
+	struct Node
+	{
+		long first, second;
+		double firstPartial, secondPartial;
+	};
+	std::vector<Node> nodes;
+	std::vector<double> adjoints;
+
+public:
+	// Tape of the calling thread, made the first time the thread records something
+	static Tape& active()
+	{
+		static thread_local Tape tape;
+		return tape;
+	}
+
+	// Record an input, a function of one node or a function of two nodes, returns the new node
+	long input()
+	{
+		long node = static_cast<long>(this->nodes.size());
+		this->nodes.push_back(Node{ node, node, 0.0, 0.0 });
+		return node;
+	}
+	long record(long first, double firstPartial)
+	{
+		this->nodes.push_back(Node{ first, first, firstPartial, 0.0 });
+		return static_cast<long>(this->nodes.size()) - 1;
+	}
+	long record(long first, double firstPartial, long second, double secondPartial)
+	{
+		this->nodes.push_back(Node{ first, second, firstPartial, secondPartial });
+		return static_cast<long>(this->nodes.size()) - 1;
+	}
+
+	// Forget all the nodes, keeps the memory
+	void rewind();
+
+	// Number of nodes recorded
+	long size() const;
+
+	// Derivatives of node result wrt every node before it, read with adjoint
+	void backward(long result);
+	double adjoint(long node) const;
+};
+
+class Number
+{
+private:
+	double val;		// Value
+	long node;		// Node on the tape of the thread
+
+	// Number made by an operation already recorded
+	Number(double value, long node) : val(value), node(node) {}
+
+public:
+	// Input (or constant) with the given value
+	Number(double value = 0.0) : val(value), node(Tape::active().input()) {}
+
+	double value() const { return this->val; }
+
+	// Derivative of the last result passed to Tape::backward wrt this number
+	double adjoint() const { return Tape::active().adjoint(this->node); }
+
+	// Derivatives of this number wrt every number on the tape
+	void propagate() const { Tape::active().backward(this->node); }
+
+	// Arithmetic
+	friend Number operator+(const Number& a, const Number& b) { return Number(a.val + b.val, Tape::active().record(a.node, 1.0, b.node, 1.0)); }
+	friend Number operator-(const Number& a, const Number& b) { return Number(a.val - b.val, Tape::active().record(a.node, 1.0, b.node, -1.0)); }
+	friend Number operator*(const Number& a, const Number& b) { return Number(a.val * b.val, Tape::active().record(a.node, b.val, b.node, a.val)); }
+	friend Number operator/(const Number& a, const Number& b)
+	{
+		double inverse = 1.0 / b.val;
+		return Number(a.val * inverse, Tape::active().record(a.node, inverse, b.node, -a.val * inverse * inverse));
+	}
+	friend Number operator-(const Number& a) { return Number(-a.val, Tape::active().record(a.node, -1.0)); }
+
+	// With plain doubles, which are constants and need no node of their own
+	friend Number operator+(const Number& a, double b) { return Number(a.val + b, Tape::active().record(a.node, 1.0)); }
+	friend Number operator+(double a, const Number& b) { return b + a; }
+	friend Number operator-(const Number& a, double b) { return Number(a.val - b, Tape::active().record(a.node, 1.0)); }
+	friend Number operator-(double a, const Number& b) { return Number(a - b.val, Tape::active().record(b.node, -1.0)); }
+	friend Number operator*(const Number& a, double b) { return Number(a.val * b, Tape::active().record(a.node, b)); }
+	friend Number operator*(double a, const Number& b) { return b * a; }
+	friend Number operator/(const Number& a, double b) { return a * (1.0 / b); }
+	friend Number operator/(double a, const Number& b)
+	{
+		double inverse = 1.0 / b.val;
+		return Number(a * inverse, Tape::active().record(b.node, -a * inverse * inverse));
+	}
+
+	Number& operator+=(const Number& b) { return *this = *this + b; }
+	Number& operator-=(const Number& b) { return *this = *this - b; }
+	Number& operator*=(const Number& b) { return *this = *this * b; }
+	Number& operator/=(const Number& b) { return *this = *this / b; }
+
+	// Comparisons, on the values
+	friend bool operator<(const Number& a, const Number& b) { return a.val < b.val; }
+	friend bool operator>(const Number& a, const Number& b) { return a.val > b.val; }
+	friend bool operator<(const Number& a, double b) { return a.val < b; }
+	friend bool operator>(const Number& a, double b) { return a.val > b; }
+
+	// Elementary functions, found by argument dependent lookup so templates can call exp(x)
+	// after using std::exp and work for double and Number alike
+	friend Number exp(const Number& a)
+	{
+		double e = std::exp(a.val);
+		return Number(e, Tape::active().record(a.node, e));
+	}
+	friend Number log(const Number& a) { return Number(std::log(a.val), Tape::active().record(a.node, 1.0 / a.val)); }
+	friend Number sqrt(const Number& a)
+	{
+		double root = std::sqrt(a.val);
+		return Number(root, Tape::active().record(a.node, 0.5 / root));
+	}
+};
+
+#endif // !AAD_HPP
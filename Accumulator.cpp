@@ -0,0 +1,125 @@
+#include "Accumulator.hpp"
+#include <cmath>
+#include <algorithm>
+
+Accumulator Accumulator::fromSums(long n, double sum, double squared, double shift)
+{
+	// The sums are of the deviations from shift, which moves the mean but not M2
+	Accumulator a;
+	if (n <= 0)
+		return a;
+	double deviation = sum / static_cast<double>(n);
+	a.n = n;
+	a.mu = shift + deviation;
+	a.M2 = std::max(squared - sum * deviation, 0.0);
+	return a;
+}
+
+void Accumulator::add(double x)
+{
+	// Welford: the mean moves by delta / n, M2 grows by the product of the deviations from the old and new mean
+	++this->n;
+	double delta = x - this->mu;
+	this->mu += delta / static_cast<double>(this->n);
+	this->M2 += delta * (x - this->mu);
+	this->minimum = std::min(this->minimum, x);
+	this->maximum = std::max(this->maximum, x);
+}
+
+void Accumulator::add(const double* x, long count)
+{
+	// Mean of the samples, then their squared deviations from it, both loops vectorise
+	if (count <= 0)
+		return;
+	Accumulator chunk;
+	double sum = 0.0;
+	for (long i = 0; i < count; ++i)
+		sum += x[i];
+	chunk.n = count;
+	chunk.mu = sum / static_cast<double>(count);
+	for (long i = 0; i < count; ++i)
+	{
+		double deviation = x[i] - chunk.mu;
+		chunk.M2 += deviation * deviation;
+		chunk.minimum = std::min(chunk.minimum, x[i]);
+		chunk.maximum = std::max(chunk.maximum, x[i]);
+	}
+	merge(chunk);
+}
+
+void Accumulator::merge(const Accumulator& other)
+{
+	// Chan et al.: the means are weighted by the counts and M2 gains the spread between the two means
+	if (other.n == 0)
+		return;
+	if (this->n == 0)
+	{
+		*this = other;
+		return;
+	}
+	double na = static_cast<double>(this->n);
+	double nb = static_cast<double>(other.n);
+	double n = na + nb;
+	double delta = other.mu - this->mu;
+	this->mu += delta * nb / n;
+	this->M2 += other.M2 + delta * delta * na * nb / n;
+	this->n += other.n;
+	this->minimum = std::min(this->minimum, other.minimum);
+	this->maximum = std::max(this->maximum, other.maximum);
+}
+
+PairAccumulator PairAccumulator::fromSums(const Accumulator& x, const Accumulator& y, double cross, double xShift, double yShift)
+{
+	// As Accumulator::fromSums, the shifts move the means but not C2
+	PairAccumulator a;
+	a.x = x;
+	a.y = y;
+	a.C2 = cross - static_cast<double>(x.getCount()) * (x.getMean() - xShift) * (y.getMean() - yShift);
+	return a;
+}
+
+void PairAccumulator::add(double xValue, double yValue)
+{
+	// Welford: C2 grows by the deviation of x from its old mean times that of y from its new mean
+	double delta = xValue - this->x.getMean();
+	this->x.add(xValue);
+	this->y.add(yValue);
+	this->C2 += delta * (yValue - this->y.getMean());
+}
+
+void PairAccumulator::merge(const PairAccumulator& other)
+{
+	// Chan et al.: C2 gains the product of the spreads between the two means of x and of y
+	if (other.x.getCount() == 0)
+		return;
+	if (this->x.getCount() == 0)
+	{
+		*this = other;
+		return;
+	}
+	double na = static_cast<double>(this->x.getCount());
+	double nb = static_cast<double>(other.x.getCount());
+	double deltaX = other.x.getMean() - this->x.getMean();
+	double deltaY = other.y.getMean() - this->y.getMean();
+	this->C2 += other.C2 + deltaX * deltaY * na * nb / (na + nb);
+	this->x.merge(other.x);
+	this->y.merge(other.y);
+}
+
+// Get functions
+const Accumulator& PairAccumulator::getX() const { return this->x; }
+const Accumulator& PairAccumulator::getY() const { return this->y; }
+double PairAccumulator::getCovariance() const 
+{ 
+	return (this->x.getCount() > 0) ? this->C2 / static_cast<double>(this->x.getCount()) : 0.0; 
+}
+
+// Get functions
+long Accumulator::getCount() const { return this->n; }
+double Accumulator::getMean() const { return this->mu; }
+double Accumulator::getSum() const { return this->mu * static_cast<double>(this->n); }
+double Accumulator::getVariance() const { return (this->n > 0) ? this->M2 / static_cast<double>(this->n) : 0.0; }
+double Accumulator::getStandardDeviation() const { return std::sqrt(getVariance()); }
+double Accumulator::getStandardError() const { return (this->n > 0) ? getStandardDeviation() / std::sqrt(static_cast<double>(this->n)) : 0.0; }
+double Accumulator::getMinimum() const { return this->minimum; }
+double Accumulator::getMaximum() const { return this->maximum; }
@@ -0,0 +1,79 @@
+#ifndef ACCUMULATOR_HPP
+#define ACCUMULATOR_HPP
+
+// Built-in header files
+#include <limits>
+
+/* ABOUT
+	- Running statistics of a stream of samples: count, mean, M2 (the sum of squared deviations from
+	  the mean), minimum and maximum
+	- Samples are added with Welford's update and two accumulators are merged in O(1) with the pairwise
+	  formulas of Chan, Golub and LeVeque (1979), so the partial results of blocks, threads, batches or
+	  processes can be combined. Merging in a fixed order gives the same numbers on any number of threads
+	- The variance is M2 / n, a sum of squared deviations, instead of sum2 / n - mean^2, which cancels
+	  when the mean is large compared with the spread and loses more digits as n grows
+	- Vectorised kernels that only keep plain sums over a short block are lifted with fromSums. They sum
+	  the deviations from a shift close to the mean (such as the mean of the first few samples), so the
+	  sum of squares less the square of the sum only cancels over the distance of the mean from the shift
+	- PairAccumulator does the same for pairs of samples (x, y), with their co-moment C2 (the sum of 
+	  the products of the deviations from the means) for the covariance, updated and merged alike*/
+
+// Monte Carlo estimate of one quantity at one spot: the mean, the standard deviation of the samples
+// and the standard error of the mean
+struct Estimate
+{
+	double value, SD, SE;
+};
+
+class Accumulator
+{
+private:
+	long n;
+	double mu, M2, minimum, maximum;
+
+public:
+	Accumulator() : n(0), mu(0.0), M2(0.0), minimum(std::numeric_limits<double>::infinity()),
+		maximum(-std::numeric_limits<double>::infinity()) {}
+
+	// Statistics of n samples x with the given sum and sum of squares of x - shift, minimum and maximum are not known
+	static Accumulator fromSums(long n, double sum, double squared, double shift);
+
+	// Add one sample, n samples (in two passes over them, then merged) or the samples of another accumulator
+	void add(double x);
+	void add(const double* x, long count);
+	void merge(const Accumulator& other);
+
+	// Get functions, the variance is that of the samples (divided by n) as elsewhere in the Monte Carlo engine
+	long getCount() const;
+	double getMean() const;
+	double getSum() const;
+	double getVariance() const;
+	double getStandardDeviation() const;
+	double getStandardError() const;
+	double getMinimum() const;
+	double getMaximum() const;
+};
+
+class PairAccumulator
+{
+private:
+	Accumulator x, y;
+	double C2;
+
+public:
+	PairAccumulator() : x(), y(), C2(0.0) {}
+
+	// Statistics of the pairs of samples with the given statistics of x and y and sum of products (x - xShift) (y - yShift)
+	static PairAccumulator fromSums(const Accumulator& x, const Accumulator& y, double cross, double xShift, double yShift);
+
+	// Add one pair or the pairs of another accumulator
+	void add(double xValue, double yValue);
+	void merge(const PairAccumulator& other);
+
+	// Get functions, the covariance is divided by n as the variances
+	const Accumulator& getX() const;
+	const Accumulator& getY() const;
+	double getCovariance() const;
+};
+
+#endif // !ACCUMULATOR_HPP
@@ -0,0 +1,272 @@
+#ifndef BATCH_MATH_HPP
+#define BATCH_MATH_HPP
+
+// Built-in header files
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+
+/* ABOUT
+	- Elementary functions and the normal distribution function and its inverse, written with 
+	  plain arithmetic, bit operations and square roots only, so loops that
+	  call them over arrays are vectorised by the compiler (a call to std::exp, std::log, ...
+	  stops most compilers from vectorising a loop)
+	- Accurate to a couple of ulp over the ranges used by the Monte Carlo engine
+	- The functions are static so every file gets its own copy, built with that file's instruction
+	  set, and the linker never mixes AVX copies into the rest of the program
+	- Conversions between integers and doubles use the 1.5 * 2^52 rounding trick instead of casts, 
+	  as 64 bit integer conversions have no vector instruction before AVX-512*/
+
+static inline double batchBitsToDouble(int64_t bits)
+{
+	double x;
+	std::memcpy(&x, &bits, sizeof(x));
+	return x;
+}
+
+static inline int64_t batchDoubleToBits(double x)
+{
+	int64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	return bits;
+}
+
+static inline double batchExp(double x)
+{
+	// Cody-Waite reduction x = n * ln(2) + r with |r| <= ln(2)/2, a degree 13 Taylor
+	// polynomial for exp(r) and the exponent bits of 2^n set directly. For |x| < 700
+	const double log2e = 1.4426950408889634;
+	const double ln2Hi = 6.93147180369123816490e-01;
+	const double ln2Lo = 1.90821492927058770002e-10;
+	const double roundMagic = 6755399441055744.0;	// 1.5 * 2^52, adding it rounds to an integer
+
+	// Clamped on the magnitude, a single select which compilers if-convert in any loop
+	double magnitude = std::fabs(x);
+	x = std::copysign((magnitude > 700.0) ? 700.0 : magnitude, x);
+
+	double shifted = x * log2e + roundMagic;
+	double n = shifted - roundMagic;
+	double r = (x - n * ln2Hi) - n * ln2Lo;
+
+	double p = 1.0 / 6227020800.0;
+	p = p * r + 1.0 / 479001600.0;
+	p = p * r + 1.0 / 39916800.0;
+	p = p * r + 1.0 / 3628800.0;
+	p = p * r + 1.0 / 362880.0;
+	p = p * r + 1.0 / 40320.0;
+	p = p * r + 1.0 / 5040.0;
+	p = p * r + 1.0 / 720.0;
+	p = p * r + 1.0 / 120.0;
+	p = p * r + 1.0 / 24.0;
+	p = p * r + 1.0 / 6.0;
+	p = p * r + 0.5;
+	p = p * r + 1.0;
+	p = p * r + 1.0;
+
+	// 2^n from the exponent bits, n is read from the low bits of the shifted value
+	int64_t integer = batchDoubleToBits(shifted) - batchDoubleToBits(roundMagic);
+	return p * batchBitsToDouble((integer + 1023) << 52);
+}
+
+static inline double batchLog(double x)
+{
+	// Natural logarithm of a positive normal number. x = 2^e * m with m in [sqrt(1/2), sqrt(2)),
+	// log(m) = 2 * atanh(s) with s = (m - 1)/(m + 1), |s| < 0.172, summed up to s^21
+	const double ln2Hi = 6.93147180369123816490e-01;
+	const double ln2Lo = 1.90821492927058770002e-10;
+	const int64_t sqrtHalfBits = 0x3FE6A09E667F3BCDLL;	// Bits of sqrt(1/2)
+	const double roundMagic = 6755399441055744.0;
+
+	// Shift the exponent so the mantissa lands in [sqrt(1/2), sqrt(2))
+	int64_t bits = batchDoubleToBits(x) - sqrtHalfBits;
+	int64_t e = bits >> 52;
+	double m = batchBitsToDouble((bits & 0x000FFFFFFFFFFFFFLL) + sqrtHalfBits);
+
+	double s = (m - 1.0) / (m + 1.0);
+	double z = s * s;
+	double p = 1.0 / 21.0;
+	p = p * z + 1.0 / 19.0;
+	p = p * z + 1.0 / 17.0;
+	p = p * z + 1.0 / 15.0;
+	p = p * z + 1.0 / 13.0;
+	p = p * z + 1.0 / 11.0;
+	p = p * z + 1.0 / 9.0;
+	p = p * z + 1.0 / 7.0;
+	p = p * z + 1.0 / 5.0;
+	p = p * z + 1.0 / 3.0;
+
+	// e as a double without an integer conversion instruction
+	double n = batchBitsToDouble(batchDoubleToBits(roundMagic) + e) - roundMagic;
+	return n * ln2Hi + (2.0 * s + (2.0 * s * z * p + n * ln2Lo));
+}
+
+static inline void batchSinCos(double x, double& sine, double& cosine)
+{
+	// Sine and cosine for |x| < 1e5. Cody-Waite reduction x = n * pi/2 + r with |r| <= pi/4,
+	// Taylor polynomials for sin(r) and cos(r), then the quadrant n mod 4 picks and signs them
+	const double twoOverPi = 0.63661977236758134308;
+	const double piOver2Hi = 1.57079632673412561417e+00;
+	const double piOver2Mid = 6.07710050650619224932e-11;
+	const double piOver2Lo = 2.02226624879595063154e-21;
+	const double roundMagic = 6755399441055744.0;
+
+	double shifted = x * twoOverPi + roundMagic;
+	double n = shifted - roundMagic;
+	double r = ((x - n * piOver2Hi) - n * piOver2Mid) - n * piOver2Lo;
+	double z = r * r;
+
+	double s = -1.0 / 121645100408832000.0;		// -1/19!
+	s = s * z + 1.0 / 355687428096000.0;
+	s = s * z - 1.0 / 1307674368000.0;
+	s = s * z + 1.0 / 6227020800.0;
+	s = s * z - 1.0 / 39916800.0;
+	s = s * z + 1.0 / 362880.0;
+	s = s * z - 1.0 / 5040.0;
+	s = s * z + 1.0 / 120.0;
+	s = s * z - 1.0 / 6.0;
+	s = r + r * z * s;
+
+	double c = 1.0 / 6402373705728000.0;		// 1/18!
+	c = c * z - 1.0 / 20922789888000.0;
+	c = c * z + 1.0 / 87178291200.0;
+	c = c * z - 1.0 / 479001600.0;
+	c = c * z + 1.0 / 3628800.0;
+	c = c * z - 1.0 / 40320.0;
+	c = c * z + 1.0 / 720.0;
+	c = c * z - 1.0 / 24.0;
+	c = c * z + 0.5;
+	c = 1.0 - z * c;
+
+	// Quadrant, read from the low bits of the shifted value
+	int64_t q = (batchDoubleToBits(shifted) - batchDoubleToBits(roundMagic)) & 3;
+	double sinR = (q & 1) ? c : s;
+	double cosR = (q & 1) ? s : c;
+	sine = (q == 2 || q == 3) ? -sinR : sinR;
+	cosine = (q == 1 || q == 2) ? -cosR : cosR;
+}
+
+static inline double batchQuarterGaussian(double x)
+{
+	// exp(-x^2/4), the square root of exp(-x^2/2), without the rounding error of x^2 growing with x: 
+	// x = xr + (x - xr) with xr a multiple of 1/16, so xr^2 is exact and x^2 = xr^2 + (x - xr)(x + xr).
+	// exp(-x^2/2) is the product of two of them, which stays exact into the subnormal range where
+	// exp(-x^2/2) itself is out of the range of batchExp
+	const double roundMagic = 6755399441055744.0;
+	double xr = ((16.0 * x + roundMagic) - roundMagic) * 0.0625;
+	return batchExp(-0.25 * xr * xr) * batchExp(-0.25 * (x - xr) * (x + xr));
+}
+
+static inline double batchNormalCDF(double x)
+{
+	// Standard normal distribution function, Cody's rational approximations (ANORM, ACM TOMS 715)
+	// for |x| <= 0.66291, |x| <= sqrt(32) and beyond, each near double precision relative to the
+	// smaller of N(x) and 1 - N(x). All three are computed and one is picked, so there are no branches
+	const double oneOverSqrtTwoPi = 0.39894228040143267794;
+	double a = (x < 0.0) ? -x : x;
+
+	// Centre, N(x) = 1/2 + x R(x^2)
+	double z = a * a;
+	double num = 0.065682337918207449113 * z;
+	double den = z;
+	num = (num + 2.2352520354606839287) * z;
+	den = (den + 47.20258190468824187) * z;
+	num = (num + 161.02823106855587881) * z;
+	den = (den + 976.09855173777669322) * z;
+	num = (num + 1067.6894854603709582) * z;
+	den = (den + 10260.932208618978205) * z;
+	double centre = a * (num + 18154.981253343561249) / (den + 45507.789335026729956);
+
+	// Middle, 1 - N(|x|) = exp(-x^2/2) R(|x|)
+	num = 1.0765576773720192317e-8 * a;
+	den = a;
+	num = (num + 0.39894151208813466764) * a;
+	den = (den + 22.266688044328115691) * a;
+	num = (num + 8.8831497943883759412) * a;
+	den = (den + 235.38790178262499861) * a;
+	num = (num + 93.506656132177855979) * a;
+	den = (den + 1519.377599407554805) * a;
+	num = (num + 597.27027639480026226) * a;
+	den = (den + 6485.558298266760755) * a;
+	num = (num + 2494.5375852903726711) * a;
+	den = (den + 18615.571640885098091) * a;
+	num = (num + 6848.1904505362823326) * a;
+	den = (den + 34900.952721145977266) * a;
+	num = (num + 11602.651437647350124) * a;
+	den = (den + 38912.003286093271411) * a;
+	double middle = (num + 9842.7148383839780218) / (den + 19685.429676859990727);
+
+	// Tail, 1 - N(|x|) = exp(-x^2/2) (1/sqrt(2 pi) - R(1/x^2)/x^2) / |x|
+	double w = 1.0 / (z > 1.0 ? z : 1.0);
+	num = 0.02307344176494017303 * w;
+	den = w;
+	num = (num + 0.21589853405795699) * w;
+	den = (den + 1.28426009614491121) * w;
+	num = (num + 0.1274011611602473639) * w;
+	den = (den + 0.468238212480865118) * w;
+	num = (num + 0.022235277870649807) * w;
+	den = (den + 0.0659881378689285515) * w;
+	num = (num + 0.001421619193227893466) * w;
+	den = (den + 0.00378239633202758244) * w;
+	double tail = (oneOverSqrtTwoPi - w * (num + 2.9112874951168792e-5) / (den + 7.29751555083966205e-5)) / a;
+
+	// exp(-x^2/2) R as (exp(-x^2/4) R) exp(-x^2/4), rounded once at the end when it is subnormal
+	double root = batchQuarterGaussian(a);
+	double upperTail = (root * ((a <= 5.656854249492380195) ? middle : tail)) * root;
+	upperTail = (a > 38.5) ? 0.0 : upperTail;	// Below half the smallest subnormal double
+	double lower = (a <= 0.66291) ? 0.5 - centre : upperTail;
+	return (x > 0.0) ? 1.0 - lower : lower;
+}
+
+static inline double batchNormalCDFInverse(double p)
+{
+	// Inverse of the standard normal distribution function for p in (0,1), p not subnormal.
+	// Acklam's rational approximations (relative error 1.15e-9), central for 0.02425 <= p <= 0.97575 
+	// and tail outside, then one Halley step on N(x) = p which brings it to full double precision.
+	// The Halley step works in the lower half, x <= 0, where N is accurate relative to p
+	const double sqrtTwoPi = 2.50662827463100050242;
+	bool upper = (p > 0.5);
+	double pl = upper ? 1.0 - p : p;
+
+	// Central region
+	double q = p - 0.5;
+	double r = q * q;
+	double num = -3.969683028665376e+01;
+	num = num * r + 2.209460984245205e+02;
+	num = num * r - 2.759285104469687e+02;
+	num = num * r + 1.383577518672690e+02;
+	num = num * r - 3.066479806614716e+01;
+	num = num * r + 2.506628277459239e+00;
+	double den = -5.447609879822406e+01;
+	den = den * r + 1.615858368580409e+02;
+	den = den * r - 1.556989798598866e+02;
+	den = den * r + 6.680131188771972e+01;
+	den = den * r - 1.328068155288572e+01;
+	den = den * r + 1.0;
+	double central = num * q / den;
+
+	// Lower tail, the upper tail from symmetry
+	double t = std::sqrt(-2.0 * batchLog(pl));
+	num = -7.784894002430293e-03;
+	num = num * t - 3.223964580411365e-01;
+	num = num * t - 2.400758277161838e+00;
+	num = num * t - 2.549732539343734e+00;
+	num = num * t + 4.374664141464968e+00;
+	num = num * t + 2.938163982698783e+00;
+	den = 7.784695709041462e-03;
+	den = den * t + 3.224671290700398e-01;
+	den = den * t + 2.445134137142996e+00;
+	den = den * t + 3.754408661907416e+00;
+	den = den * t + 1.0;
+	double tail = num / den;
+
+	// Approximation in the lower half, y = -|x|
+	double y = (pl < 0.02425) ? tail : (upper ? -central : central);
+
+	// Halley step, dividing by the density exp(-y^2/2) / sqrt(2 pi) one square root at a time
+	double root = batchQuarterGaussian(y);
+	double u = ((batchNormalCDF(y) - pl) / root) * sqrtTwoPi / root;
+	y = y - u / (1.0 + 0.5 * y * u);
+	return upper ? -y : y;
+}
+
+#endif // !BATCH_MATH_HPP
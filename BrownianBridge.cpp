@@ -0,0 +1,67 @@
+#include "BrownianBridge.hpp"
+#include <cmath>
+
+BrownianBridge::BrownianBridge(long NT) : NT(NT), bridgeIndex(NT), leftIndex(NT), rightIndex(NT),
+	leftWeight(NT), rightWeight(NT), stdDev(NT)
+{
+	// Works with unit steps, point l at time l + 1. filled[l] is true once some normal makes point l
+	if (NT <= 0)
+		return;
+	std::vector<bool> filled(NT, false);
+
+	// The first normal makes the end point
+	filled[NT - 1] = true;
+	this->bridgeIndex[0] = NT - 1;
+	this->stdDev[0] = std::sqrt(static_cast<double>(NT));
+
+	// Each following normal makes the middle of the next gap, the left end j - 1 (or time 0 when j = 0)
+	// and the right end k are made already
+	long j = 0;
+	for (long i = 1; i < NT; ++i)
+	{
+		while (filled[j])
+			++j;
+		long k = j;
+		while (!filled[k])
+			++k;
+		long l = j + ((k - 1 - j) >> 1);
+		filled[l] = true;
+		this->bridgeIndex[i] = l;
+		this->leftIndex[i] = j;
+		this->rightIndex[i] = k;
+
+		// Conditional distribution of W(l + 1) between W(j) and W(k + 1)
+		double left = static_cast<double>(j), middle = static_cast<double>(l + 1), right = static_cast<double>(k + 1);
+		this->leftWeight[i] = (right - middle) / (right - left);
+		this->rightWeight[i] = (middle - left) / (right - left);
+		this->stdDev[i] = std::sqrt((middle - left) * (right - middle) / (right - left));
+
+		// Move on to the next gap, back to the start after the last one
+		j = k + 1;
+		if (j >= NT)
+			j = 0;
+	}
+}
+
+long BrownianBridge::getNumberOfSteps() const { return this->NT; }
+
+void BrownianBridge::buildIncrements(const double* Z, double dt, double* W, double* dW) const
+{
+	// Make the points in the order of the normals, W(0) = 0 is the left end of the first gaps
+	if (this->NT <= 0)
+		return;
+	W[this->NT - 1] = this->stdDev[0] * Z[0];
+	for (long i = 1; i < this->NT; ++i)
+	{
+		long j = this->leftIndex[i];
+		long l = this->bridgeIndex[i];
+		double left = (j > 0) ? W[j - 1] : 0.0;
+		W[l] = this->leftWeight[i] * left + this->rightWeight[i] * W[this->rightIndex[i]] + this->stdDev[i] * Z[i];
+	}
+
+	// Increments of the path, scaled from unit steps to dt
+	double scale = std::sqrt(dt);
+	dW[0] = scale * W[0];
+	for (long l = 1; l < this->NT; ++l)
+		dW[l] = scale * (W[l] - W[l - 1]);
+}
@@ -0,0 +1,35 @@
+#ifndef BROWNIAN_BRIDGE_HPP
+#define BROWNIAN_BRIDGE_HPP
+
+// Built-in header files
+#include <vector>
+
+/* ABOUT
+	- Brownian bridge construction of the Wiener increments of a path with NT equal steps
+	- The first normal fixes the end point W(T), the next the middle, then the quarter points and 
+	  so on, each point drawn from its distribution given the two points around it already made
+	- Gives the same distribution of paths as the increments in time order, but puts most of the
+	  variance of the path (and of smooth payoffs of it) in the first few normals. Used with the 
+	  quasi-random generator, whose first dimensions are the best distributed, see Sobol.hpp
+	- The order of the points and the weights are worked out once (Jaeckel, Monte Carlo Methods in 
+	  Finance, 2002), building a path is then one multiply-add per step*/
+
+class BrownianBridge
+{
+private:
+	long NT;
+	std::vector<long> bridgeIndex, leftIndex, rightIndex;	// Point made by normal i and the points around it
+	std::vector<double> leftWeight, rightWeight, stdDev;	// Its conditional mean weights and standard deviation
+
+public:
+	explicit BrownianBridge(long NT = 1);
+
+	// Number of steps
+	long getNumberOfSteps() const;
+
+	// Wiener increments dW[0], ..., dW[NT - 1] of the path with step dt from the normals Z[0], ..., Z[NT - 1],
+	// W is a buffer of NT doubles
+	void buildIncrements(const double* Z, double dt, double* W, double* dW) const;
+};
+
+#endif // !BROWNIAN_BRIDGE_HPP
@@ -0,0 +1,68 @@
+#include "InstructionSet.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static InstructionSet detectInstructionSet()
+{
+	// Checks both that the CPU has the instructions and that the OS saves the wider registers
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	if (maxLeaf < 7)
+		return InstructionSet::Baseline;
+
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool fma = (info[2] & (1 << 12)) != 0;
+	if (!osxsave)
+		return InstructionSet::Baseline;
+	unsigned long long xcr0 = _xgetbv(0);
+	bool osAVX = (xcr0 & 0x6) == 0x6;			// XMM and YMM state
+	bool osAVX512 = (xcr0 & 0xE6) == 0xE6;		// and opmask, ZMM state
+
+	__cpuidex(info, 7, 0);
+	bool avx2 = (info[1] & (1 << 5)) != 0;
+	bool avx512f = (info[1] & (1 << 16)) != 0;
+	bool avx512dq = (info[1] & (1 << 17)) != 0;
+	bool avx512vl = (info[1] & (1 << 31)) != 0;
+
+	if (osAVX512 && avx512f && avx512dq && avx512vl)
+		return InstructionSet::AVX512;
+	if (osAVX && avx2 && fma)
+		return InstructionSet::AVX2;
+	return InstructionSet::Baseline;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+		return InstructionSet::AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return InstructionSet::AVX2;
+	return InstructionSet::Baseline;
+#else
+	return InstructionSet::Baseline;
+#endif
+}
+
+InstructionSet instructionSetInUse()
+{
+	// Detected once, the first time a kernel is chosen
+	static const InstructionSet isa = detectInstructionSet();
+	return isa;
+}
+
+std::string instructionSetName()
+{
+	// Name of the instruction set used by the kernels
+	switch (instructionSetInUse())
+	{
+	case InstructionSet::AVX512:
+		return "AVX-512";
+	case InstructionSet::AVX2:
+		return "AVX2";
+	default:
+		return "Baseline";
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef INSTRUCTION_SET_HPP
+#define INSTRUCTION_SET_HPP
+
+// Built-in header files
+#include <string>
+
+/* ABOUT
+	- Detects the widest vector instruction set the CPU and OS support
+	- The vectorised kernels (batch SDE schemes, batch normals, normal distribution) are compiled once per instruction
+	  set: the baseline copies with the project's default flags, the others in Kernels_avx2.cpp and 
+	  Kernels_avx512.cpp with /arch:AVX2 and /arch:AVX512, and the callers pick the copy to use
+	  from instructionSetInUse()*/
+
+enum class InstructionSet { Baseline, AVX2, AVX512 };
+
+// Instruction set used by the kernels, detected once
+InstructionSet instructionSetInUse();
+
+// Name of the instruction set used by the kernels
+std::string instructionSetName();
+
+#endif // !INSTRUCTION_SET_HPP
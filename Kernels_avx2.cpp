@@ -0,0 +1,10 @@
+// AVX2 copies of the vectorised kernels (batch SDE schemes, batch normals, normal distribution)
+// Compiled with /arch:AVX2 (see WbsProject.vcxproj), only called on CPUs that support AVX2
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC target("avx2,fma")
+#endif
+
+#define KERNEL_SUFFIX AVX2
+#include "SDEBatchKernels.inl"
+#include "RNGKernels.inl"
+#include "NormalKernels.inl"
@@ -0,0 +1,10 @@
+// AVX-512 copies of the vectorised kernels (batch SDE schemes, batch normals, normal distribution)
+// Compiled with /arch:AVX512 (see WbsProject.vcxproj), only called on CPUs that support AVX-512
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC target("avx512f,avx512dq,avx512vl,avx2,fma")
+#endif
+
+#define KERNEL_SUFFIX AVX512
+#include "SDEBatchKernels.inl"
+#include "RNGKernels.inl"
+#include "NormalKernels.inl"
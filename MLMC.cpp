@@ -0,0 +1,218 @@
+#include "MLMC.hpp"
+#include "SDEBatch.hpp"
+#include "RNG.hpp"
+#include "Parallel.hpp"
+#include "StopWatch.cpp"
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Weak order of the Euler scheme (the bias falls as 2^-ALPHA per level) and the decay of the 
+// level variances (2^-BETA per level), used for the bias test and for a new level's first variance
+static const double ALPHA = 1.0;
+static const double BETA = 1.0;
+
+// Levels started with, the bias test needs two levels after the first
+static const long MIN_LEVELS = 3;
+
+MLMC::MLMC(const OptionData& OD, long NT0, double accuracy) : myOption(OD), NT0(NT0), initialPaths(10000), 
+	maxLevels(12), accuracy(accuracy), option_price(0.0), SE(0.0), time_elapsed(0.0), 
+	nThreads(defaultNumberOfThreads()), seed(0), converged(false) {}
+
+// Set functions
+void MLMC::setCoarsestSteps(long NT0) { this->NT0 = NT0; }
+void MLMC::setAccuracy(double accuracy) { this->accuracy = accuracy; }
+void MLMC::setInitialPaths(long initialPaths) { this->initialPaths = initialPaths; }
+void MLMC::setMaxLevels(long maxLevels) { this->maxLevels = maxLevels; }
+void MLMC::setNumberOfThreads(unsigned nThreads) { this->nThreads = (nThreads == 0) ? 1 : nThreads; }
+void MLMC::setSeed(uint32_t seed) { this->seed = seed; }
+
+// Get functions
+double MLMC::getOptionPrice() { return this->option_price; }
+double MLMC::getStandardError() { return this->SE; }
+double MLMC::getTimeElapsed() { return this->time_elapsed; }
+bool MLMC::getConverged() { return this->converged; }
+std::vector<MLMCLevel> MLMC::getLevels() { return this->levels; }
+
+double MLMC::getCost() { return totalCost(); }
+double MLMC::getSingleLevelCost() { return singleLevelCost(); }
+
+double MLMC::totalCost() const
+{
+	double cost = 0.0;
+	for (const MLMCLevel& level : this->levels)
+		cost += level.M * level.cost;
+	return cost;
+}
+
+double MLMC::singleLevelCost() const
+{
+	// Paths for a variance of accuracy^2 / 2 with the variance of the finest payoff, each of the finest steps
+	if (this->levels.empty())
+		return 0.0;
+	const MLMCLevel& finest = this->levels.back();
+	return std::ceil(2.0 * finest.fineVariance() / (this->accuracy * this->accuracy)) * finest.NT;
+}
+
+void MLMC::run(double S)
+{
+	if (this->NT0 < 1 || this->accuracy <= 0.0 || this->initialPaths < 2 || this->maxLevels < MIN_LEVELS)
+	{
+		std::stringstream os;
+		os << "Invalid multilevel parameters (NT0, accuracy, initial paths, max levels) = (" << this->NT0 << ", "
+			<< this->accuracy << ", " << this->initialPaths << ", " << this->maxLevels << ")";
+		throw std::invalid_argument(os.str());
+	}
+	StopWatch<> sw;
+	sw.Start();
+
+	// Start with the first levels and the initial paths on each
+	this->levels.clear();
+	std::vector<long> extra;
+	for (long l = 0; l < MIN_LEVELS; ++l)
+	{
+		this->levels.push_back(MLMCLevel{ this->NT0 << l, 0, Accumulator(), Accumulator(), 
+			static_cast<double>((this->NT0 << l) + ((l > 0) ? (this->NT0 << (l - 1)) : 0)) });
+		extra.push_back(this->initialPaths);
+	}
+
+	double target = 0.5 * this->accuracy * this->accuracy;
+	this->converged = false;
+	while (true)
+	{
+		// Run the extra paths of every level
+		long nLevels = static_cast<long>(this->levels.size());
+		for (long l = 0; l < nLevels; ++l)
+		{
+			if (extra[l] > 0)
+				runLevel(S, l, this->levels[l].M + 1, this->levels[l].M + extra[l]);
+		}
+
+		// Variances, each from level 2 on kept at least half the value the decay 2^-BETA predicts from
+		// the level before. The floor is there for new levels, whose first paths may show too small a 
+		// variance, and applies at every iteration, so it can only add paths
+		std::vector<double> V(nLevels);
+		double total = 0.0;
+		for (long l = 0; l < nLevels; ++l)
+		{
+			V[l] = this->levels[l].variance();
+			if (l >= 2)
+				V[l] = std::max(V[l], 0.5 * V[l - 1] / std::pow(2.0, BETA));
+			total += std::sqrt(V[l] * this->levels[l].cost);
+		}
+
+		// Optimal paths of each level: M_l proportional to sqrt(V_l / C_l), for a variance of accuracy^2 / 2
+		bool enough = true;
+		for (long l = 0; l < nLevels; ++l)
+		{
+			long optimal = static_cast<long>(std::ceil(std::sqrt(V[l] / this->levels[l].cost) * total / target));
+			extra[l] = std::max(0L, optimal - this->levels[l].M);
+			if (extra[l] > 0.01 * this->levels[l].M)
+				enough = false;
+		}
+		if (!enough)
+			continue;
+
+		// Bias of the finest grid from the means of the last two levels
+		double last = std::fabs(this->levels[nLevels - 1].mean());
+		double previous = std::fabs(this->levels[nLevels - 2].mean()) / std::pow(2.0, ALPHA);
+		double bias = std::max(last, previous) / (std::pow(2.0, ALPHA) - 1.0);
+		if (bias <= std::sqrt(target))
+		{
+			this->converged = true;
+			break;
+		}
+		if (nLevels >= this->maxLevels)
+			break;
+
+		// Otherwise add a finer level
+		long NT = this->NT0 << nLevels;
+		this->levels.push_back(MLMCLevel{ NT, 0, Accumulator(), Accumulator(), static_cast<double>(NT + NT / 2) });
+		extra.push_back(this->initialPaths);
+	}
+
+	// Price and standard error from the sum of the levels
+	double price = 0.0, variance = 0.0;
+	for (const MLMCLevel& level : this->levels)
+	{
+		price += level.mean();
+		variance += level.variance() / level.M;
+	}
+	this->option_price = std::exp(-myOption.r * myOption.T) * price;
+	this->SE = std::sqrt(variance);
+
+	sw.Stop();
+	this->time_elapsed = sw.GetTime();
+}
+
+void MLMC::runLevel(double S, long level, long first, long last)
+{
+	// Blocks of the paths shared between the threads, their statistics merged in block order
+	long nBlocks = (last - first + SDEBatch::PATHS_PER_BLOCK) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<Accumulator> blockSamples(nBlocks), blockFine(nBlocks);
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		long blockFirst = first + b * SDEBatch::PATHS_PER_BLOCK;
+		long blockLast = std::min(last, blockFirst + SDEBatch::PATHS_PER_BLOCK - 1);
+		levelBlock(S, level, blockFirst, blockLast, blockSamples[b], blockFine[b]);
+	});
+
+	MLMCLevel& l = this->levels[level];
+	for (long b = 0; b < nBlocks; ++b)
+	{
+		l.samples.merge(blockSamples[b]);
+		l.fine.merge(blockFine[b]);
+	}
+	l.M = last;
+}
+
+void MLMC::levelBlock(double S, long level, long first, long last, Accumulator& samples, Accumulator& fineSamples)
+{
+	// Runs the paths of a level SDEBatch::LANES at a time: the fine increments in their lanes,
+	// the coarse increments the sums of pairs of them, and the payoffs of both grids
+	const long L = SDEBatch::LANES;
+	long fineSteps = this->levels[level].NT;
+	long coarseSteps = fineSteps / 2;
+	SDEBatch fine(this->myOption, 0, fineSteps);
+	SDEBatch coarse(this->myOption, 0, std::max(1L, coarseSteps));
+	RNG randGen(fineSteps, 0, this->seed, static_cast<uint32_t>(level));
+	double dt = this->myOption.T / static_cast<double>(fineSteps);
+
+	std::vector<double> fineDW(fineSteps * L), coarseDW(coarseSteps * L), increments(fineSteps + 1);
+	double finePayoffs[L], coarsePayoffs[L], Y[L];
+
+	for (long batch = first; batch <= last; batch += L)
+	{
+		long lanes = std::min(L, last - batch + 1);
+		SDEBatch::loadBatchIncrements(randGen, batch, lanes, fineSteps, dt, fineDW.data(), increments.data());
+		for (long j = 0; j < coarseSteps; ++j)
+			for (long l = 0; l < L; ++l)
+				coarseDW[j * L + l] = fineDW[2 * j * L + l] + fineDW[(2 * j + 1) * L + l];
+
+		fine.generatePayoffs(S, fineDW.data(), finePayoffs);
+		if (level > 0)
+			coarse.generatePayoffs(S, coarseDW.data(), coarsePayoffs);
+
+		for (long l = 0; l < lanes; ++l)
+			Y[l] = finePayoffs[l] - ((level > 0) ? coarsePayoffs[l] : 0.0);
+		samples.add(Y, lanes);
+		fineSamples.add(finePayoffs, lanes);
+	}
+}
+
+// Print functions
+std::ostream& operator<<(std::ostream& os, const MLMC& mlmc)
+{
+	// Table of the levels, then the totals against a single level run of the same accuracy
+	os << "level, NT, M, mean, variance, cost per path\n";
+	for (std::size_t l = 0; l < mlmc.levels.size(); ++l)
+	{
+		const MLMCLevel& level = mlmc.levels[l];
+		os << l << ", " << level.NT << ", " << level.M << ", " << level.mean() << ", " << level.variance() 
+			<< ", " << level.cost << "\n";
+	}
+	os << "price " << mlmc.option_price << ", standard error " << mlmc.SE << ", cost " << mlmc.totalCost() 
+		<< ", single level cost " << mlmc.singleLevelCost() << (mlmc.converged ? "" : " (bias test failed)");
+	return os;
+}
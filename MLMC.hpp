@@ -0,0 +1,94 @@
+#ifndef MLMC_HPP
+#define MLMC_HPP
+
+// Built-in header files
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+// Custom header files
+#include "OptionData.hpp"
+#include "Accumulator.hpp"
+
+/* ABOUT
+	- Multilevel Monte Carlo (Giles 2008, 2015) for the Euler scheme
+	- Level l runs the Euler scheme with NT0 * 2^l steps. Level 0 estimates the price on the coarsest 
+	  grid, level l > 0 the difference between the payoffs of a path on grid l and the path on grid
+	  l - 1 made from the same Wiener process (each coarse increment is the sum of two fine ones). The
+	  sum of the levels is the price on the finest grid, and since the two paths of a level are close 
+	  the differences have a small variance, so most of the paths are run on the cheap coarse grids
+	- The number of paths of each level is chosen from the estimated variances and costs so the
+	  variance of the price is accuracy^2 / 2 at the least cost; levels are added until the estimated
+	  bias of the finest grid is below accuracy / sqrt(2), so the root mean square error is about accuracy
+	- Estimates the limit of an infinite number of steps: the European price without time step error,
+	  and the Asian prices with continuous averaging (as the closed forms in FairValue)
+	- The paths of each level are run in blocks on all the threads with the vectorised payoff kernels 
+	  of SDEBatch; every level uses its own stream of the random number generator, so the results only
+	  depend on the seed
+	- As in MonteCarlo the accuracy, standard error and variances are those of the undiscounted payoffs*/
+
+// Paths, statistics and cost of one level: the level's samples (the difference of the fine and coarse
+// payoffs) and the fine payoffs on their own
+struct MLMCLevel
+{
+	long NT, M;
+	Accumulator samples, fine;
+	double cost;	// Time steps per path, fine and coarse
+
+	double mean() const { return samples.getMean(); }
+	double variance() const { return (M > 1) ? samples.getVariance() : 0.0; }
+	double fineVariance() const { return (M > 1) ? fine.getVariance() : 0.0; }
+};
+
+class MLMC
+{
+private:
+	OptionData myOption;
+	long NT0;				// Time steps of the coarsest level
+	long initialPaths;		// Paths run on a new level before its variance is used
+	long maxLevels;			// Highest number of levels
+	double accuracy;		// Target root mean square error
+	double option_price, SE, time_elapsed;
+	unsigned nThreads;
+	uint32_t seed;
+	bool converged;			// false if the bias test failed on the last level allowed
+	std::vector<MLMCLevel> levels;
+
+	// Runs paths first, ..., last (inclusive) of a level, adding to its statistics
+	void runLevel(double S, long level, long first, long last);
+	void levelBlock(double S, long level, long first, long last, Accumulator& samples, Accumulator& fineSamples);
+
+	// Costs in time steps, see getCost and getSingleLevelCost
+	double totalCost() const;
+	double singleLevelCost() const;
+
+public:
+	// Constructor and destructors
+	MLMC(const OptionData& OD, long NT0, double accuracy);
+	~MLMC() {}
+
+	// Set functions
+	void setCoarsestSteps(long NT0);
+	void setAccuracy(double accuracy);
+	void setInitialPaths(long initialPaths);
+	void setMaxLevels(long maxLevels);
+	void setNumberOfThreads(unsigned nThreads);
+	void setSeed(uint32_t seed);
+
+	// Get functions
+	double getOptionPrice();
+	double getStandardError();
+	double getTimeElapsed();
+	bool getConverged();
+	std::vector<MLMCLevel> getLevels();
+	double getCost();				// Time steps run over all the levels
+	double getSingleLevelCost();	// Time steps a plain Monte Carlo run on the finest grid needs for the same accuracy
+
+	// Main function, prices the option at spot S
+	void run(double S);
+
+	// Print functions, one line per level with its steps, paths, mean, variance and cost
+	friend std::ostream& operator<< (std::ostream& os, const MLMC& mlmc);
+};
+
+#endif // !MLMC_HPP
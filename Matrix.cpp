@@ -0,0 +1,94 @@
+#include "Matrix.hpp"
+#include <algorithm>
+
+Matrix::Matrix(long rows, long cols, double value) : rows(0), cols(0), stride(0), offset(0)
+{
+	resize(rows, cols, value);
+}
+
+Matrix::Matrix(const Matrix& m) : rows(m.rows), cols(m.cols), stride(m.stride), storage(m.storage.size()), offset(0)
+{
+	// The copy's storage has its own address, so it is aligned again before the elements are copied
+	align();
+	for (long i = 0; i < this->rows; ++i)
+		std::copy(m.row(i), m.row(i) + this->stride, row(i));
+}
+
+Matrix::Matrix(Matrix&& m) : rows(m.rows), cols(m.cols), stride(m.stride), storage(std::move(m.storage)), offset(m.offset)
+{
+	// Moving keeps the buffer, and so the alignment, the source is left empty
+	m.clear();
+}
+
+Matrix& Matrix::operator=(const Matrix& m)
+{
+	if (this != &m)
+	{
+		Matrix temp(m);
+		this->rows = temp.rows;
+		this->cols = temp.cols;
+		this->stride = temp.stride;
+		this->storage.swap(temp.storage);	// Swapping keeps the buffer, and so the alignment
+		this->offset = temp.offset;
+	}
+	return *this;
+}
+
+Matrix& Matrix::operator=(Matrix&& m)
+{
+	if (this != &m)
+	{
+		this->rows = m.rows;
+		this->cols = m.cols;
+		this->stride = m.stride;
+		this->storage = std::move(m.storage);
+		this->offset = m.offset;
+		m.clear();
+	}
+	return *this;
+}
+
+long Matrix::paddedColumns(long cols)
+{
+	// Rounds up to a whole number of alignment units
+	return ((cols + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+}
+
+void Matrix::align()
+{
+	// Skips the doubles before the first 64 byte boundary of the storage
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(this->storage.data());
+	std::uintptr_t bytes = ALIGNMENT * sizeof(double);
+	this->offset = ((bytes - address % bytes) % bytes) / sizeof(double);
+}
+
+StridedView Matrix::column(long j)
+{
+	StridedView view = { row(0) + j, this->rows, this->stride };
+	return view;
+}
+
+std::vector<double> Matrix::rowVector(long i) const
+{
+	return std::vector<double>(row(i), row(i) + this->cols);
+}
+
+void Matrix::resize(long rows, long cols, double value)
+{
+	// One block for all the rows, plus room to move the first row to an aligned address
+	this->rows = rows;
+	this->cols = cols;
+	this->stride = paddedColumns(cols);
+	std::vector<double> temp(static_cast<std::size_t>(rows * this->stride + ALIGNMENT), value);
+	this->storage.swap(temp);
+	align();
+}
+
+void Matrix::clear()
+{
+	this->rows = 0;
+	this->cols = 0;
+	this->stride = 0;
+	this->offset = 0;
+	std::vector<double>().swap(this->storage);
+}
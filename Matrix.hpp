@@ -0,0 +1,79 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+// Built-in header files
+#include <vector>
+#include <cstdint>
+
+/* ABOUT
+	- Dense matrix of doubles in one contiguous block, row after row, used for the Wiener
+	  increments and the stored paths (one row per path, one column per time step)
+	- One allocation for the whole matrix instead of one per row, so a sweep over the paths reads
+	  memory in order. Every row starts on a 64 byte boundary (the row stride is rounded up to a
+	  multiple of 8 doubles), so the rows can be read with aligned vector loads of any width
+	- A row (path) is a plain pointer to its elements, a column (time slice) is a strided view*/
+
+// Strided view of some elements of a matrix, e.g. one column
+struct StridedView
+{
+	double* first;	// First element
+	long size;		// Number of elements
+	long stride;	// Distance between two elements
+
+	double& operator[](long k) const { return first[k * stride]; }
+};
+
+class Matrix
+{
+private:
+	long rows, cols, stride;
+	std::vector<double> storage;	// Elements and padding, with room to align the first row
+	std::size_t offset;				// Index of the first element in storage
+
+	// Elements per row including the padding
+	static long paddedColumns(long cols);
+
+	// Sets offset so the first element is aligned
+	void align();
+
+public:
+	// Number of doubles in one alignment unit
+	static const long ALIGNMENT = 8;
+
+	// Constructors
+	Matrix() : rows(0), cols(0), stride(0), offset(0) {}
+	Matrix(long rows, long cols, double value = 0.0);
+	Matrix(const Matrix& m);
+	Matrix(Matrix&& m);
+	Matrix& operator=(const Matrix& m);
+	Matrix& operator=(Matrix&& m);
+	~Matrix() {}
+
+	// Get functions
+	long getRows() const { return this->rows; }
+	long getColumns() const { return this->cols; }
+	long getStride() const { return this->stride; }
+	bool empty() const { return this->rows == 0; }
+
+	// Element access
+	double& operator()(long i, long j) { return this->storage[this->offset + i * this->stride + j]; }
+	double operator()(long i, long j) const { return this->storage[this->offset + i * this->stride + j]; }
+
+	// Row i, e.g. one path, as a pointer to its getColumns() elements
+	double* row(long i) { return this->storage.data() + this->offset + i * this->stride; }
+	const double* row(long i) const { return this->storage.data() + this->offset + i * this->stride; }
+
+	// Column j, e.g. one time step of every path
+	StridedView column(long j);
+
+	// Row i copied into a vector
+	std::vector<double> rowVector(long i) const;
+
+	// Changes the size, the elements are set to value
+	void resize(long rows, long cols, double value = 0.0);
+
+	// Releases the memory
+	void clear();
+};
+
+#endif // !MATRIX_HPP
@@ -0,0 +1,199 @@
+#include "MaturityLadder.hpp"
+#include "SDEBatch.hpp"
+#include "RNG.hpp"
+#include "Parallel.hpp"
+#include "StopWatch.cpp"
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Tolerance, relative to the number of steps, for a maturity to fall on the time grid
+static const double GRID_TOLERANCE = 1e-9;
+
+// Steps whose price ratios S / S0 are multiplied together before taking one log (geometric averages).
+// Each ratio S_j / S0 is within a few exp(sigma sqrt(T)) of 1 for any realistic volatility and maturity, 
+// so the product of 16 of them stays far inside the range of a double (about exp(+-708))
+static const long LOG_CHUNK = 16;
+
+MaturityLadder::MaturityLadder(const OptionData& OD, const std::vector<double>& maturities, long NT, long M, int SDE_type) : 
+	myOption(OD), maturities(maturities), NT(NT), M(M), SDE_type(SDE_type), nThreads(defaultNumberOfThreads()), 
+	seed(0), time_elapsed(0.0) {}
+
+// Set functions
+void MaturityLadder::setNumberOfSimulations(long M) { this->M = M; }
+void MaturityLadder::setNumberOfThreads(unsigned nThreads) { this->nThreads = (nThreads == 0) ? 1 : nThreads; }
+void MaturityLadder::setSeed(uint32_t seed) { this->seed = seed; }
+
+// Get functions
+double MaturityLadder::getTimeElapsed() { return this->time_elapsed; }
+std::vector<double> MaturityLadder::getMaturities() { return this->maturities; }
+std::vector<long> MaturityLadder::getSteps() { return this->steps; }
+
+std::vector<Estimate> MaturityLadder::getEstimates()
+{
+	std::vector<Estimate> estimates;
+	for (std::size_t m = 0; m < this->payoffs.size(); ++m)
+	{
+		Estimate e;
+		e.value = std::exp(-this->myOption.r * this->maturities[m]) * this->payoffs[m].getMean();
+		e.SD = this->payoffs[m].getStandardDeviation();
+		e.SE = this->payoffs[m].getStandardError();
+		estimates.push_back(e);
+	}
+	return estimates;
+}
+
+void MaturityLadder::run()
+{
+	if (this->maturities.empty() || this->NT < 1 || this->M < 1 || this->myOption.style < 0 || this->myOption.style > 2)
+	{
+		std::stringstream os;
+		os << "Invalid maturity ladder (maturities, NT, M, style) = (" << this->maturities.size() << ", " << this->NT 
+			<< ", " << this->M << ", " << this->myOption.style << ")";
+		throw std::invalid_argument(os.str());
+	}
+
+	// The grid runs to the longest maturity, every maturity must be a whole number of its steps
+	double T = *std::max_element(this->maturities.begin(), this->maturities.end());
+	double dt = T / static_cast<double>(this->NT);
+	this->steps.clear();
+	for (double maturity : this->maturities)
+	{
+		double n = maturity / dt;
+		long rounded = std::lround(n);
+		if (!(maturity > 0.0) || std::fabs(n - static_cast<double>(rounded)) > GRID_TOLERANCE * std::max(1.0, n))
+		{
+			std::stringstream os;
+			os << "Maturity " << maturity << " is not on the time grid of " << this->NT << " steps of " << dt 
+				<< " up to " << T << "; use a number of steps for which every maturity is a multiple of the step";
+			throw std::invalid_argument(os.str());
+		}
+		this->steps.push_back(rounded);
+	}
+	// The simulation runs the option to the longest maturity, the caller's option is left as it is
+	OptionData OD(this->myOption);
+	OD.T = T;
+	StopWatch<> sw;
+	sw.Start();
+
+	// Blocks of the paths shared between the threads, their statistics merged in block order
+	long nMaturities = static_cast<long>(this->maturities.size());
+	long nBlocks = (this->M + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<Accumulator> blockPayoffs(nBlocks * nMaturities);
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		long first = 1 + b * SDEBatch::PATHS_PER_BLOCK;
+		long last = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK);
+		ladderBlock(OD, first, last, blockPayoffs.data() + b * nMaturities);
+	});
+
+	this->payoffs.assign(nMaturities, Accumulator());
+	for (long b = 0; b < nBlocks; ++b)
+		for (long m = 0; m < nMaturities; ++m)
+			this->payoffs[m].merge(blockPayoffs[b * nMaturities + m]);
+
+	sw.Stop();
+	this->time_elapsed = sw.GetTime();
+}
+
+void MaturityLadder::ladderBlock(const OptionData& OD, long first, long last, Accumulator* payoffs) const
+{
+	// Runs the paths SDEBatch::LANES at a time to the longest maturity, then walks along the prices of each 
+	// lane keeping the running average of the style, and takes the payoffs at every maturity on the way
+	const long L = SDEBatch::LANES;
+	long nMaturities = static_cast<long>(this->maturities.size());
+	SDEBatch sde(OD, this->SDE_type, this->NT);
+	RNG randGen(this->NT, this->M, this->seed);
+	double dt = OD.T / static_cast<double>(this->NT);
+	std::vector<double> batch_dW(this->NT * L), increments(this->NT + 1);
+	std::vector<double> plus((this->NT + 1) * L), minus((this->NT + 1) * L);
+	double runningPlus[L], runningMinus[L], chunkPlus[L], chunkMinus[L], pairPayoffs[L];
+	bool geometric = (OD.style == 2);
+	double S0 = OD.S0;
+	double inverseS0 = 1.0 / S0;
+
+	for (long batch = first; batch <= last; batch += L)
+	{
+		// Increments of the paths in their lanes, unused lanes get zeros
+		long lanes = std::min(L, last - batch + 1);
+		SDEBatch::loadBatchIncrements(randGen, batch, lanes, this->NT, dt, batch_dW.data(), increments.data());
+		sde.generatePaths(OD.S0, batch_dW.data(), plus.data(), minus.data());
+
+		// Running sums of the prices (arithmetic) or of the logs of S / S0 (geometric) up to each step, 
+		// the geometric ones as the sum over whole chunks and the product of the ratios in the current chunk
+		for (long l = 0; l < L; ++l)
+		{
+			runningPlus[l] = geometric ? 0.0 : plus[l];
+			runningMinus[l] = geometric ? 0.0 : minus[l];
+			chunkPlus[l] = geometric ? plus[l] * inverseS0 : 1.0;
+			chunkMinus[l] = geometric ? minus[l] * inverseS0 : 1.0;
+		}
+		for (long j = 1; j <= this->NT; ++j)
+		{
+			if (geometric)
+			{
+				for (long l = 0; l < L; ++l)
+				{
+					chunkPlus[l] *= plus[j * L + l] * inverseS0;
+					chunkMinus[l] *= minus[j * L + l] * inverseS0;
+				}
+				if (j % LOG_CHUNK == 0)
+				{
+					for (long l = 0; l < L; ++l)
+					{
+						runningPlus[l] += std::log(chunkPlus[l]);
+						runningMinus[l] += std::log(chunkMinus[l]);
+						chunkPlus[l] = 1.0;
+						chunkMinus[l] = 1.0;
+					}
+				}
+			}
+			else
+			{
+				for (long l = 0; l < L; ++l)
+				{
+					runningPlus[l] += plus[j * L + l];
+					runningMinus[l] += minus[j * L + l];
+				}
+			}
+
+			// Payoffs of the options expiring after j steps, from the price or the average of the j + 1 prices
+			for (long m = 0; m < nMaturities; ++m)
+			{
+				if (this->steps[m] != j)
+					continue;
+				double n = static_cast<double>(j + 1);
+				for (long l = 0; l < lanes; ++l)
+				{
+					double averagePlus = plus[j * L + l], averageMinus = minus[j * L + l];
+					if (OD.style == 1)
+					{
+						averagePlus = runningPlus[l] / n;
+						averageMinus = runningMinus[l] / n;
+					}
+					else if (geometric)
+					{
+						averagePlus = S0 * std::exp((runningPlus[l] + std::log(chunkPlus[l])) / n);
+						averageMinus = S0 * std::exp((runningMinus[l] + std::log(chunkMinus[l])) / n);
+					}
+					pairPayoffs[l] = 0.5 * (OD.payoff(averagePlus) + OD.payoff(averageMinus));
+				}
+				payoffs[m].add(pairPayoffs, lanes);
+			}
+		}
+	}
+}
+
+// Print functions
+std::ostream& operator<<(std::ostream& os, const MaturityLadder& ladder)
+{
+	os << "maturity, steps, price, standard error\n";
+	for (std::size_t m = 0; m < ladder.payoffs.size(); ++m)
+	{
+		os << ladder.maturities[m] << ", " << ladder.steps[m] << ", " 
+			<< std::exp(-ladder.myOption.r * ladder.maturities[m]) * ladder.payoffs[m].getMean() << ", " 
+			<< ladder.payoffs[m].getStandardError() << "\n";
+	}
+	return os;
+}
@@ -0,0 +1,64 @@
+#ifndef MATURITY_LADDER_HPP
+#define MATURITY_LADDER_HPP
+
+// Built-in header files
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+// Custom header files
+#include "OptionData.hpp"
+#include "Accumulator.hpp"
+
+/* ABOUT
+	- Prices an option at a ladder of maturities from one simulation to the longest of them
+	- The paths run on NT equal steps up to the longest maturity, dt = T / NT. Every maturity must be a
+	  whole number of steps n, otherwise run throws std::invalid_argument; the option expiring after n
+	  steps is then priced from the first n steps of the paths (the price after n steps, or the average
+	  of the first n + 1 prices) and discounted with its own maturity
+	- The normals of a path do not depend on the number of steps, so the price at maturity T_m is the one
+	  a MonteCarlo run of the option with T_m, n steps, M paths and the same seed gives, up to rounding,
+	  without the control variate
+	- One Accumulator per maturity, the blocks of paths run on all the threads and are merged in block order*/
+
+class MaturityLadder
+{
+private:
+	OptionData myOption;	// Strike, type, style and dynamics, its T is not used
+	std::vector<double> maturities;
+	std::vector<long> steps;	// Time steps to each maturity
+	long NT, M;
+	int SDE_type;	// 0 for Euler, 1 for exact simulation
+	unsigned nThreads;
+	uint32_t seed;
+	double time_elapsed;
+	std::vector<Accumulator> payoffs;	// Undiscounted payoffs at each maturity
+
+	// Runs paths first, ..., last (inclusive) of the option OD, with T the longest maturity, and adds 
+	// their payoffs at maturity m to payoffs[m]
+	void ladderBlock(const OptionData& OD, long first, long last, Accumulator* payoffs) const;
+
+public:
+	// Constructor and destructors, the time grid has NT steps up to the longest of the maturities
+	MaturityLadder(const OptionData& OD, const std::vector<double>& maturities, long NT, long M, int SDE_type);
+	~MaturityLadder() {}
+
+	// Set functions
+	void setNumberOfSimulations(long M);
+	void setNumberOfThreads(unsigned nThreads);
+	void setSeed(uint32_t seed);
+
+	// Get functions
+	double getTimeElapsed();
+	std::vector<double> getMaturities();
+	std::vector<long> getSteps();			// Time steps to each maturity, after run
+	std::vector<Estimate> getEstimates();	// Discounted price, standard deviation and standard error at each maturity, in order
+
+	// Main function, prices the option at every maturity
+	void run();
+
+	// Print functions, one line per maturity with its steps, price and standard error
+	friend std::ostream& operator<< (std::ostream& os, const MaturityLadder& ladder);
+};
+
+#endif // !MATURITY_LADDER_HPP
@@ -4,6 +4,75 @@
 #include <tuple>
 #include <stdexcept>
 
+// Sums kept per spot by the grid blocks: sum and sum of squares of the payoff, the delta and the gamma,
+// then the sum and sum of squares of the geometric control and the sum of its products with the payoff
+static const long GRID_SUMS = 9;
+
+// Shifts kept per spot by the grid blocks, taken off the samples before they are summed: those of the 
+// payoff (and of the strata), the delta, the gamma and the geometric control
+static const long GRID_SHIFTS = 4;
+
+// Samples kept by the sensitivity blocks: the price and its five sensitivities
+static const long SENSITIVITY_SAMPLES = 6;
+
+static Estimate estimate(const Accumulator& samples, double discount)
+{
+	// Discounted mean, standard deviation and standard error of the samples,
+	// as in calculatePrice the standard deviation is that of the undiscounted samples
+	Estimate e;
+	e.value = discount * samples.getMean();
+	e.SD = samples.getStandardDeviation();
+	e.SE = samples.getStandardError();
+	return e;
+}
+
+static Estimate controlledEstimate(const PairAccumulator& samples, double controlMean, double discount, double& reduction)
+{
+	// Control variate estimate from pairs of controls X with known mean E[X] and samples Y: 
+	// Y - beta (X - E[X]) with the variance minimising beta = Cov(X, Y) / Var(X), estimated from 
+	// the same samples. Its variance is Var(Y) (1 - rho^2), and reduction = 1 / (1 - rho^2)
+	double MC = static_cast<double>(samples.getY().getCount());
+	double meanY = samples.getY().getMean();
+	double meanX = samples.getX().getMean();
+	double varY = samples.getY().getVariance();
+	double varX = samples.getX().getVariance();
+	double cov = samples.getCovariance();
+	double beta = (varX > 0.0) ? cov / varX : 0.0;
+	double residual = std::max(varY - beta * cov, 0.0);
+
+	Estimate e;
+	e.value = discount * (meanY - beta * (meanX - controlMean));
+	e.SD = std::sqrt(residual);
+	e.SE = e.SD / std::sqrt(MC);
+	reduction = (residual > 0.0) ? varY / residual : 1.0;
+	return e;
+}
+
+static Estimate stratifiedEstimate(const std::vector<Accumulator>& strata, const Accumulator& payoffs, double discount, 
+	double& reduction)
+{
+	// Stratified estimate from the samples of each of the equally likely strata and of all of them:
+	// the mean of the stratum means, with variance the sum of Var(Y | stratum s) / (strata^2 n_s). SD is
+	// that of one sample with the same error, with proportional allocation the square root of the 
+	// within-strata variance, and reduction is the variance of the plain estimator over it
+	double K = static_cast<double>(strata.size());
+	double mean = 0.0, variance = 0.0;
+	for (const Accumulator& stratum : strata)
+	{
+		if (stratum.getCount() == 0)
+			continue;
+		mean += stratum.getMean() / K;
+		variance += stratum.getVariance() / (K * K * static_cast<double>(stratum.getCount()));
+	}
+
+	Estimate e;
+	e.value = discount * mean;
+	e.SE = std::sqrt(variance);
+	e.SD = e.SE * std::sqrt(static_cast<double>(payoffs.getCount()));
+	reduction = (e.SD > 0.0) ? payoffs.getVariance() / (e.SD * e.SD) : 1.0;
+	return e;
+}
+
 // Set functions
 void MonteCarlo::setInitialPrice(double S)
 {
@@ -16,6 +85,24 @@ void MonteCarlo::setNumberOfSteps(long NT) { this->NT = NT; }
 void MonteCarlo::setStepSize(double dS) { this->dS = dS; }
 void MonteCarlo::setNumberOfSimulations(long M) { this->M = M; }
 void MonteCarlo::setOptionData(const OptionData& op) {this->myOption = op;}
+void MonteCarlo::setStreaming(bool streaming) { this->streaming = streaming; }
+void MonteCarlo::setNumberOfThreads(unsigned nThreads) { this->nThreads = (nThreads == 0) ? 1 : nThreads; }
+void MonteCarlo::setSeed(uint32_t seed) { this->seed = seed; }
+void MonteCarlo::setStoreIncrements(bool storeIncrements) { this->storeIncrements = storeIncrements; }
+void MonteCarlo::setSpotScaling(bool spotScaling) { this->spotScaling = spotScaling; }
+void MonteCarlo::setPathwiseGreeks(bool pathwiseGreeks) { this->pathwiseGreeks = pathwiseGreeks; }
+void MonteCarlo::setAdjointSensitivities(bool adjointSensitivities) { this->adjointSensitivities = adjointSensitivities; }
+void MonteCarlo::setControlVariate(bool controlVariate) { this->controlVariate = controlVariate; }
+void MonteCarlo::setAdaptive(bool adaptive) { this->adaptive = adaptive; }
+void MonteCarlo::setBatchSize(long batchSize) { this->batchSize = batchSize; }
+void MonteCarlo::setMinBatches(long minBatches) { this->minBatches = minBatches; }
+void MonteCarlo::setMaxSimulations(long maxSimulations) { this->maxSimulations = maxSimulations; }
+void MonteCarlo::setQuasiRandom(bool quasiRandom) { this->quasiRandom = quasiRandom; }
+void MonteCarlo::setReplications(long replications) { this->replications = replications; }
+void MonteCarlo::setStratified(bool stratified) { this->stratified = stratified; }
+void MonteCarlo::setStrata(long strata) { this->strata = strata; }
+void MonteCarlo::setMomentMatching(int momentMatching) { this->momentMatching = momentMatching; }
+void MonteCarlo::setImportanceSampling(bool importanceSampling) { this->importanceSampling = importanceSampling; }
 
 // Get functions
 double MonteCarlo::getOptionPrice() { return this->option_price; }
@@ -25,7 +112,26 @@ double MonteCarlo::getStandardError() { return this->SE; }
 long MonteCarlo::getNumberOfTimeSteps() { return this->NT; }
 double MonteCarlo::getTimeElapsed() { return this->time_elapsed; }
 long MonteCarlo::getNumberOfSimulations() { return this->M; }
+unsigned MonteCarlo::getNumberOfThreads() { return this->nThreads; }
+uint32_t MonteCarlo::getSeed() { return this->seed; }
+bool MonteCarlo::getStoreIncrements() { return this->storeIncrements; }
+bool MonteCarlo::getSpotScaling() { return this->spotScaling; }
+bool MonteCarlo::getPathwiseGreeks() { return this->pathwiseGreeks; }
+bool MonteCarlo::getAdjointSensitivities() { return this->adjointSensitivities; }
+bool MonteCarlo::getControlVariate() { return this->controlVariate; }
+bool MonteCarlo::getAdaptive() { return this->adaptive; }
+long MonteCarlo::getBatchSize() { return this->batchSize; }
+long MonteCarlo::getMinBatches() { return this->minBatches; }
+long MonteCarlo::getMaxSimulations() { return this->maxSimulations; }
+bool MonteCarlo::getQuasiRandom() { return this->quasiRandom; }
+long MonteCarlo::getReplications() { return this->replications; }
+bool MonteCarlo::getStratified() { return this->stratified; }
+long MonteCarlo::getStrata() { return this->strata; }
+int MonteCarlo::getMomentMatching() { return this->momentMatching; }
+bool MonteCarlo::getImportanceSampling() { return this->importanceSampling; }
+Sensitivities MonteCarlo::getSensitivities() { return this->sensitivities; }
 int MonteCarlo::getSDEtype() { return this->SDE_type; }
+bool MonteCarlo::getStreaming() { return this->streaming; }
 char MonteCarlo::getOptionType() { return this->myOption.getType(); }
 FairValue MonteCarlo::getFairOption() { return this->fairOption; }
 std::map<double, double> MonteCarlo::getStdDev() { return this->stddev; }
@@ -33,22 +139,118 @@ std::map<double, double> MonteCarlo::getStdErr() { return this->stderror; }
 std::map<double, double> MonteCarlo::getPrices() { return this->prices; }
 std::map<double, double> MonteCarlo::getDeltas() { return this->deltas; }
 std::map<double, double> MonteCarlo::getGammas() { return this->gammas; }
+std::map<double, double> MonteCarlo::getDeltaStdErr() { return this->deltaStdErr; }
+std::map<double, double> MonteCarlo::getGammaStdErr() { return this->gammaStdErr; }
+std::map<double, double> MonteCarlo::getDriftShifts() { return this->driftShifts; }
+std::map<double, double> MonteCarlo::getVarianceReduction() { return this->varianceReduction; }
 
 // Main functions
 void MonteCarlo::run()
 {
 	// Generate the paths using path recycling (same Wiener process matrix for each price) 
-	RNG randGen(this->NT, this->M);
+	// When the matrix is not stored, the streaming engine regenerates each path's increments
+	// from the seed and path number for every price, which gives exactly the same numbers
+	// An adaptive run picks M itself, see streamGrid
+	if (this->adaptive && !(this->streaming && this->spotScaling))
+	{
+		std::stringstream os;
+		os << "Adaptive runs need streaming with spot scaling";
+		throw std::invalid_argument(os.str());
+	}
+	if (this->adaptive && (this->batchSize <= 0 || this->maxSimulations <= 0))
+	{
+		std::stringstream os;
+		os << "Adaptive runs need a positive batch size and cap, got " << this->batchSize << " and " << this->maxSimulations;
+		throw std::invalid_argument(os.str());
+	}
+	// A quasi-random run rounds M up to whole replications, see streamGrid
+	if (this->quasiRandom && (!(this->streaming && this->spotScaling) || this->adaptive))
+	{
+		std::stringstream os;
+		os << "Quasi-random runs need streaming with spot scaling and no adaptive stopping";
+		throw std::invalid_argument(os.str());
+	}
+	if (this->quasiRandom)
+	{
+		if (this->replications < 2)
+		{
+			std::stringstream os;
+			os << "Quasi-random runs need at least 2 replications, got " << this->replications;
+			throw std::invalid_argument(os.str());
+		}
+		this->M = ((this->M + this->replications - 1) / this->replications) * this->replications;
+		this->sobol = std::make_shared<Sobol>(this->NT, this->M, this->seed, this->replications);
+	}
+	else
+		this->sobol.reset();
+
+	// Importance sampling shifts each spot's paths on their own, so the spots cannot share the paths
+	if (this->importanceSampling && this->streaming && this->spotScaling)
+	{
+		std::stringstream os;
+		os << "Importance sampling needs the paths of each spot on their own, turn off spot scaling or streaming";
+		throw std::invalid_argument(os.str());
+	}
+
+	// A stratified run keeps the payoff sums of each stratum, which streamPaths does not, and rounds M
+	// up to whole cycles through the strata so that every stratum gets the same number of paths
+	if (this->stratified && ((this->streaming && !this->spotScaling) || this->quasiRandom))
+	{
+		std::stringstream os;
+		os << "Stratified runs need spot scaling or stored paths, and pseudo-random numbers";
+		throw std::invalid_argument(os.str());
+	}
+	if (this->stratified)
+	{
+		if (this->strata < 1)
+		{
+			std::stringstream os;
+			os << "Stratified runs need at least 1 stratum, got " << this->strata;
+			throw std::invalid_argument(os.str());
+		}
+		long cycle = SDEBatch::LANES * this->strata;
+		if (!this->adaptive)
+			this->M = ((this->M + cycle - 1) / cycle) * cycle;
+		long paths = this->adaptive ? this->maxSimulations : this->M;
+		this->stratifiedRNG = std::make_shared<StratifiedRNG>(this->NT, paths, this->seed, this->strata, SDEBatch::LANES);
+	}
+	else
+		this->stratifiedRNG.reset();
+
+	// Moment matching needs all the increments at once, see RNG::matchMoments
+	if (this->momentMatching != 0 && !this->incrementsStored())
+	{
+		std::stringstream os;
+		os << "Moment matching needs the Wiener matrix, turn on storeIncrements and off adaptive stopping";
+		throw std::invalid_argument(os.str());
+	}
+
+	RNG randGen(this->NT, this->M, this->seed);
 	double dt = this->myOption.T / static_cast<double>(this->NT);
-	this->dW = randGen.generateWienerProcesses(dt);
+	if (this->incrementsStored() && this->quasiRandom)
+		this->dW = this->sobol->generateWienerProcesses(dt, this->nThreads);
+	else if (this->incrementsStored() && this->stratified)
+		this->dW = this->stratifiedRNG->generateWienerProcesses(dt, this->nThreads);
+	else if (this->incrementsStored())
+		this->dW = randGen.generateWienerProcesses(dt, this->nThreads);
+	if (this->incrementsStored())
+		RNG::matchMoments(this->dW, this->NT, dt, this->momentMatching, this->nThreads);
 	
-	// Generate stock paths and prices
+	// Generate stock paths and prices, with the delta and gamma estimators when they are made in the same pass
 	generatePrices(this->Smin, this->Smax, this->dS);
 	
-	// Calculate the delta and gamma with numerical methods for differentiation
-	FDM finmethod(this->prices);
-	this->deltas = finmethod.FOCD();
-	this->gammas = finmethod.SOCD();
+	// Otherwise calculate the delta and gamma with numerical methods for differentiation, which
+	// leave them empty on fewer than 3 spots
+	if (!greeksInPass())
+	{
+		FDM finmethod(this->prices);
+		this->deltas = finmethod.FOCD();
+		this->gammas = finmethod.SOCD();
+	}
+
+	// Sensitivities to all the option data at the current price
+	if (this->adjointSensitivities)
+		calculateSensitivities(this->myOption.S0);
 //	printSummary();
 }
 
@@ -63,37 +265,436 @@ void MonteCarlo::rerun()
 	this->prices.clear();
 	this->deltas.clear();
 	this->gammas.clear();
+	this->deltaStdErr.clear();
+	this->gammaStdErr.clear();
+	this->varianceReduction.clear();
+	this->driftShifts.clear();
 	this->run();
 }
 
 void MonteCarlo::generatePaths(double S)
 {
-	// Generates path starting with initial price s
-	SDE sde(this->myOption, SDE_type, NT);
-	double M = static_cast<double>(this->M);
-	std::tuple<std::vector<double>, std::vector<double>> myTuple;
+	// Generates path starting with initial price s. With importance sampling the Brownian motion has
+	// drift drift_shift, which is the same as lowering the dividend yield by sigma * drift_shift
+	this->drift_shift = this->importanceSampling ? optimalShift(S) : 0.0;
+	OptionData simulated(this->myOption);
+	simulated.D -= this->myOption.sigma * this->drift_shift;
+	SDE sde(simulated, SDE_type, NT);
 
-	// Create a matrix to store the paths in
-	std::vector<std::vector<double>> temp_paths_plus;
-	std::vector<std::vector<double>> temp_paths_minus;
+	// Create a matrix to store the paths in, one row per simulation
+	Matrix temp_paths_plus(this->M, this->NT + 1);
+	Matrix temp_paths_minus(this->M, this->NT + 1);
 
-	// Loop through the number of simulations 
+	// Loop through the number of simulations, the paths are written straight into their rows
 	for (long i = 1; i <= this->M; ++i)
-	{
-		myTuple = sde.generatePaths(S, dW[i]);
-		
-		// Store paths
-		temp_paths_plus.push_back(std::get<0>(myTuple));
-		temp_paths_minus.push_back(std::get<1>(myTuple));
-	}
+		sde.generatePaths(S, this->dW.row(i), temp_paths_plus.row(i - 1), temp_paths_minus.row(i - 1));
+
 	// Store paths
-	this->paths_plus = temp_paths_plus;
-	this->paths_minus = temp_paths_minus;
+	this->paths_plus = std::move(temp_paths_plus);
+	this->paths_minus = std::move(temp_paths_minus);
 	
 	// Calculate the price 
 	calculatePrice();
 }
 
+void MonteCarlo::streamPaths(double S)
+{
+	// Streams the paths starting with initial price S on all the threads
+	streamPaths(S, this->importanceSampling ? optimalShift(S) : 0.0, this->nThreads, this->option_price, this->SD, this->SE);
+}
+
+void MonteCarlo::streamPaths(double S, double shift, unsigned nThreads, double& price, double& SD, double& SE)
+{
+	// Generates paths starting with initial price S and folds each path and its antithetic twin
+	// into their payoff averages as they are made, so no path is ever held in memory.
+	// The simulations are split into fixed blocks which are shared between the threads, the block
+	// statistics are then merged in block order so the results do not depend on the number of threads.
+	// Only reads the members, so several spots can be streamed at the same time.
+	// A nonzero shift is the drift of the Brownian motion for importance sampling, see SDEBatch
+	long nBlocks = (this->M + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<Accumulator> blockPayoffs(nBlocks);
+
+	parallelFor(nBlocks, nThreads, [&](long b)
+	{
+		long first = 1 + b * SDEBatch::PATHS_PER_BLOCK;
+		long last = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK);
+		streamBlock(S, shift, first, last, blockPayoffs[b]);
+	});
+
+	Accumulator payoffs;
+	for (long b = 0; b < nBlocks; ++b)
+		payoffs.merge(blockPayoffs[b]);
+
+	// Calculate standard deviation, standard error and option price
+	Estimate e = estimate(payoffs, std::exp(-myOption.r * myOption.T));
+	price = e.value;
+	SD = e.SD;
+	SE = e.SE;
+}
+
+void MonteCarlo::streamBlock(double S, double shift, long first, long last, Accumulator& payoffs)
+{
+	// Streams the simulations first, ..., last (inclusive) and adds their payoffs to payoffs
+	// The paths are advanced SDEBatch::LANES at a time by the vectorised batch kernels
+	// Each call has its own SDE and buffers so blocks can run on different threads
+	const long L = SDEBatch::LANES;
+	SDEBatch sde(this->myOption, SDE_type, NT, false, shift);
+	RNG randGen(this->NT, this->M, this->seed);
+
+	// Structure-of-arrays buffer for the increments of one batch, element [step * L + lane],
+	// and the payoffs of the paths of the batch
+	std::vector<double> batch_dW(this->NT * L);
+	double batch_payoffs[L];
+
+	// Buffer for regenerating the increments of a single path
+	std::vector<double> increments(this->NT + 1);
+
+	// Loop through the simulations in the block, one batch at a time
+	for (long batch = first; batch <= last; batch += L)
+	{
+		long lanes = std::min(L, last - batch + 1);
+
+		// Put the increments of each path in its lane
+		loadIncrements(randGen, batch, lanes, batch_dW.data(), increments);
+
+		// Advance all the lanes together, folding each path into its payoff as it goes
+		sde.generatePayoffs(S, batch_dW.data(), batch_payoffs);
+
+		// Add the payoffs of each path and its antithetic twin
+		payoffs.add(batch_payoffs, lanes);
+	}
+}
+
+void MonteCarlo::streamGrid(const std::vector<double>& spots, bool greeks, std::vector<Estimate>& prices, std::vector<Estimate>& deltas, std::vector<Estimate>& gammas)
+{
+	// Streams the paths once, started at 1, and prices every spot from them: the schemes are linear in 
+	// the initial price and so are the averages that go into the payoff, so a path from spot s is s times
+	// the path from 1. The same increments as streamPaths for every spot, so the same numbers up to rounding.
+	// With greeks the delta and gamma estimators of every spot are added up from the same paths (see
+	// SDEBatch::accumulateGreeks), otherwise deltas and gammas are left empty.
+	// For an arithmetic Asian option with the control variate on, the geometric average of every path is
+	// made as well and the prices are corrected with it, see controlledEstimate.
+	// An adaptive run adds batchSize simulations at a time (rounded up to whole blocks) and stops once
+	// there are minBatches batches and the confidence interval of every price at level 1 - alpha is within
+	// accuracy, or maxSimulations is reached; M is then the number of simulations used. The block sums
+	// are added in block order however the batches fall, so the results match a fixed run of that M.
+	// A quasi-random run prices each replication on its own, see Sobol, and the standard errors come from
+	// the spread of the replications; SD is then the standard deviation of one sample with that error.
+	// A stratified run keeps the payoffs of each stratum apart, see stratifiedEstimate
+	long nSpots = static_cast<long>(spots.size());
+	GridStatistics statistics;
+	if (this->quasiRandom)
+	{
+		// Statistics of the replication estimates of the prices, deltas and gammas, element [i * nSpots + k]
+		long R = this->sobol->getReplications();
+		long P = this->sobol->getPointsPerReplication();
+		std::vector<Accumulator> replicationEstimates(3 * nSpots);
+		std::vector<double> reductions(nSpots, 0.0);
+		for (long r = 0; r < R; ++r)
+		{
+			statistics = GridStatistics();
+			streamGridSums(spots, greeks, r * P + 1, (r + 1) * P, statistics);
+			gridEstimates(spots, greeks, statistics, prices, deltas, gammas);
+			for (long k = 0; k < nSpots; ++k)
+			{
+				double values[3] = { prices[k].value, greeks ? deltas[k].value : 0.0, greeks ? gammas[k].value : 0.0 };
+				for (long i = 0; i < 3; ++i)
+					replicationEstimates[i * nSpots + k].add(values[i]);
+				if (this->varianceReduction.count(spots[k]))
+					reductions[k] += this->varianceReduction[spots[k]];
+			}
+		}
+
+		// Mean of the replications, with the standard error from their sample variance
+		double RC = static_cast<double>(R);
+		double MC = static_cast<double>(this->M);
+		std::vector<Estimate>* estimates[3] = { &prices, &deltas, &gammas };
+		for (long k = 0; k < nSpots; ++k)
+		{
+			for (long i = 0; i < (greeks ? 3 : 1); ++i)
+			{
+				const Accumulator& replication = replicationEstimates[i * nSpots + k];
+				Estimate& e = (*estimates[i])[k];
+				e.value = replication.getMean();
+				e.SE = std::sqrt(replication.getVariance() / (RC - 1.0));
+				e.SD = e.SE * std::sqrt(MC);
+			}
+			if (this->varianceReduction.count(spots[k]))
+				this->varianceReduction[spots[k]] = reductions[k] / RC;
+		}
+		return;
+	}
+
+	long batchBlocks = std::max(1L, (this->batchSize + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK);
+	long limit = this->adaptive ? this->maxSimulations : this->M;
+	double z = this->adaptive ? NormalCDFInverse(1.0 - this->alpha / 2.0) : 0.0;
+	long simulations = 0, batches = 0;
+	bool done = false;
+
+	while (!done)
+	{
+		// Next batch, or all the simulations at once
+		long last = this->adaptive ? std::min(limit, simulations + batchBlocks * SDEBatch::PATHS_PER_BLOCK) : limit;
+		streamGridSums(spots, greeks, simulations + 1, last, statistics);
+		simulations = last;
+		++batches;
+
+		// Estimates of the simulations so far and the widest confidence interval
+		gridEstimates(spots, greeks, statistics, prices, deltas, gammas);
+		double halfWidth = 0.0;
+		for (long k = 0; k < nSpots; ++k)
+			halfWidth = std::max(halfWidth, z * prices[k].SE);
+
+		done = !this->adaptive || simulations >= limit || (batches >= this->minBatches && halfWidth <= this->accuracy);
+	}
+	this->M = simulations;
+}
+
+void MonteCarlo::gridEstimates(const std::vector<double>& spots, bool greeks, const GridStatistics& statistics, 
+	std::vector<Estimate>& prices, std::vector<Estimate>& deltas, std::vector<Estimate>& gammas)
+{
+	// Discounted estimates of each spot from the statistics of the simulations so far, see GridStatistics.
+	// With the control variate the standard error of a stratified run leaves out the strata, so it is on the safe side
+	long nSpots = static_cast<long>(spots.size());
+	double discount = std::exp(-myOption.r * myOption.T);
+	bool control = this->controlVariate && this->myOption.style == 1;
+	prices.resize(nSpots);
+	deltas.resize(greeks ? nSpots : 0);
+	gammas.resize(greeks ? nSpots : 0);
+	for (long k = 0; k < nSpots; ++k)
+	{
+		double reduction;
+		if (control)
+		{
+			prices[k] = controlledEstimate(statistics.controlled[k], geometricControlMean(spots[k]), discount, reduction);
+			this->varianceReduction[spots[k]] = reduction;
+		}
+		else if (this->stratified)
+		{
+			std::vector<Accumulator> strata(this->strata);
+			for (long s = 0; s < this->strata; ++s)
+				strata[s] = statistics.strata[s * nSpots + k];
+			prices[k] = stratifiedEstimate(strata, statistics.price[k], discount, reduction);
+			this->varianceReduction[spots[k]] = reduction;
+		}
+		else
+			prices[k] = estimate(statistics.price[k], discount);
+		if (greeks)
+		{
+			deltas[k] = estimate(statistics.delta[k], discount);
+			gammas[k] = estimate(statistics.gamma[k], discount);
+		}
+	}
+}
+
+void MonteCarlo::streamGridSums(const std::vector<double>& spots, bool greeks, long first, long last, GridStatistics& statistics)
+{
+	// Streams the simulations first, ..., last (inclusive) and merges their statistics into statistics. As in 
+	// streamPaths the blocks, counted from first, are shared between the threads and merged in block order.
+	// The batch kernels keep plain sums of the deviations from the shifts of each block, laid out as in 
+	// streamGridBlock, which are turned into the statistics of the block (see Accumulator::fromSums)
+	long nSpots = static_cast<long>(spots.size());
+	long nSums = gridSums() * nSpots;
+	long nShifts = GRID_SHIFTS * nSpots;
+	long nBlocks = (last - first + SDEBatch::PATHS_PER_BLOCK) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<double> blockSums(nBlocks * nSums, 0.0), blockShifts(nBlocks * nShifts, 0.0);
+
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		long blockFirst = first + b * SDEBatch::PATHS_PER_BLOCK;
+		long blockLast = std::min(last, blockFirst + SDEBatch::PATHS_PER_BLOCK - 1);
+		streamGridBlock(spots, greeks, blockFirst, blockLast, blockSums.data() + b * nSums, blockShifts.data() + b * nShifts);
+	});
+
+	statistics.price.resize(nSpots);
+	statistics.delta.resize(nSpots);
+	statistics.gamma.resize(nSpots);
+	statistics.controlled.resize(nSpots);
+	statistics.strata.resize(this->stratified ? this->strata * nSpots : 0);
+	for (long b = 0; b < nBlocks; ++b)
+	{
+		long blockFirst = first + b * SDEBatch::PATHS_PER_BLOCK;
+		long blockLast = std::min(last, blockFirst + SDEBatch::PATHS_PER_BLOCK - 1);
+		long n = blockLast - blockFirst + 1;
+		const double* sums = blockSums.data() + b * nSums;
+		const double* shifts = blockShifts.data() + b * nShifts;
+		for (long k = 0; k < nSpots; ++k)
+		{
+			// In a stratified run the price of the block is made up of its strata
+			double payoffShift = shifts[k], controlShift = shifts[3 * nSpots + k];
+			Accumulator price = this->stratified ? Accumulator() : Accumulator::fromSums(n, sums[k], sums[nSpots + k], payoffShift);
+			for (long s = 0; this->stratified && s < this->strata; ++s)
+			{
+				long paths = this->stratifiedRNG->pathsInStratum(s, blockLast) - this->stratifiedRNG->pathsInStratum(s, blockFirst - 1);
+				Accumulator stratum = Accumulator::fromSums(paths, sums[(GRID_SUMS + 2 * s) * nSpots + k], 
+					sums[(GRID_SUMS + 2 * s + 1) * nSpots + k], payoffShift);
+				price.merge(stratum);
+				statistics.strata[s * nSpots + k].merge(stratum);
+			}
+			statistics.price[k].merge(price);
+			statistics.delta[k].merge(Accumulator::fromSums(n, sums[2 * nSpots + k], sums[3 * nSpots + k], shifts[nSpots + k]));
+			statistics.gamma[k].merge(Accumulator::fromSums(n, sums[4 * nSpots + k], sums[5 * nSpots + k], shifts[2 * nSpots + k]));
+			statistics.controlled[k].merge(PairAccumulator::fromSums(Accumulator::fromSums(n, sums[6 * nSpots + k], 
+				sums[7 * nSpots + k], controlShift), price, sums[8 * nSpots + k], controlShift, payoffShift));
+		}
+	}
+}
+
+void MonteCarlo::streamGridBlock(const std::vector<double>& spots, bool greeks, long first, long last, double* sums, double* shifts)
+{
+	// Streams the simulations first, ..., last (inclusive) from 1 and adds the payoff sums of every spot
+	// to sums, sums[i * nSpots + k] for sum i of spot k (see GRID_SUMS), and the delta and gamma sums with 
+	// greeks, and the control sums. In a stratified run all the paths of a batch are in one stratum and 
+	// their payoffs go to its sums, i = GRID_SUMS + 2 s and GRID_SUMS + 2 s + 1 for stratum s.
+	// The sums are of the deviations from the means of the first batch of the block, written to 
+	// shifts[i * nSpots + k] (see GRID_SHIFTS), so they only depend on the block
+	const long L = SDEBatch::LANES;
+	bool control = this->controlVariate && this->myOption.style == 1;
+	SDEBatch sde(this->myOption, SDE_type, NT, control);
+	RNG randGen(this->NT, this->M, this->seed);
+	long nSpots = static_cast<long>(spots.size());
+	std::fill(sums, sums + gridSums() * nSpots, 0.0);
+	std::fill(shifts, shifts + GRID_SHIFTS * nSpots, 0.0);
+	double* payoffShift = shifts;
+	double* deltaShift = shifts + nSpots;
+	double* gammaShift = shifts + 2 * nSpots;
+	double* controlShift = shifts + 3 * nSpots;
+
+	// Buffers for one batch, as in streamBlock
+	std::vector<double> batch_dW(this->NT * L);
+	std::vector<double> increments(this->NT + 1);
+	std::vector<double> zeros(nSpots, 0.0), unused(nSpots, 0.0);
+	SDEBatchPaths paths;
+
+	for (long batch = first; batch <= last; batch += L)
+	{
+		long lanes = std::min(L, last - batch + 1);
+		loadIncrements(randGen, batch, lanes, batch_dW.data(), increments);
+
+		// One simulation of the batch for all the spots
+		sde.generateAverages(1.0, batch_dW.data(), paths);
+
+		// The shifts are the means of the first batch, its sums from zero over its lanes
+		if (batch == first)
+		{
+			sde.accumulateGrid(spots.data(), nSpots, lanes, paths, zeros.data(), payoffShift, unused.data());
+			if (greeks)
+				sde.accumulateGreeks(spots.data(), nSpots, lanes, paths, zeros.data(), zeros.data(), deltaShift, unused.data(), 
+					gammaShift, unused.data());
+			if (control)
+				sde.accumulateControl(spots.data(), nSpots, lanes, paths, zeros.data(), zeros.data(), controlShift, 
+					unused.data(), unused.data());
+			for (long i = 0; i < GRID_SHIFTS * nSpots; ++i)
+				shifts[i] /= static_cast<double>(lanes);
+		}
+
+		double* payoffSums = this->stratified ? sums + (GRID_SUMS + 2 * this->stratifiedRNG->stratum(batch)) * nSpots : sums;
+		sde.accumulateGrid(spots.data(), nSpots, lanes, paths, payoffShift, payoffSums, payoffSums + nSpots);
+		if (greeks)
+			sde.accumulateGreeks(spots.data(), nSpots, lanes, paths, deltaShift, gammaShift, sums + 2 * nSpots, sums + 3 * nSpots, 
+				sums + 4 * nSpots, sums + 5 * nSpots);
+		if (control)
+			sde.accumulateControl(spots.data(), nSpots, lanes, paths, controlShift, payoffShift, sums + 6 * nSpots, 
+				sums + 7 * nSpots, sums + 8 * nSpots);
+	}
+}
+
+void MonteCarlo::calculateSensitivities(double S)
+{
+	// Price and its sensitivities to S0, sigma, r, D and T at spot S. Each path is recorded on the
+	// tape (SDE::generateAverages, the payoff and the discounting) and swept back once, which gives
+	// the derivatives of its discounted payoff wrt all the inputs together. Same increments and
+	// blocks as streamPaths, so the price is the same up to rounding
+	long nBlocks = (this->M + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<Accumulator> blockSamples(nBlocks * SENSITIVITY_SAMPLES);
+
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		long first = 1 + b * SDEBatch::PATHS_PER_BLOCK;
+		long last = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK);
+		sensitivityBlock(S, first, last, blockSamples.data() + b * SENSITIVITY_SAMPLES);
+	});
+
+	std::vector<Accumulator> samples(SENSITIVITY_SAMPLES);
+	for (long b = 0; b < nBlocks; ++b)
+		for (long i = 0; i < SENSITIVITY_SAMPLES; ++i)
+			samples[i].merge(blockSamples[b * SENSITIVITY_SAMPLES + i]);
+
+	// The samples are already discounted
+	this->sensitivities.price = estimate(samples[0], 1.0);
+	this->sensitivities.delta = estimate(samples[1], 1.0);
+	this->sensitivities.vega = estimate(samples[2], 1.0);
+	this->sensitivities.rho = estimate(samples[3], 1.0);
+	this->sensitivities.theta = estimate(samples[4], 1.0);
+	this->sensitivities.dividend = estimate(samples[5], 1.0);
+}
+
+void MonteCarlo::sensitivityBlock(double S, long first, long last, Accumulator* samples)
+{
+	// Records, sweeps and rewinds the tape of this thread for each of the simulations first, ..., last
+	// (inclusive), and adds each sample to samples: price, delta, vega, rho, theta, dividend
+	SDE sde(this->myOption, SDE_type, NT);
+	RNG randGen(this->NT, this->M, this->seed);
+	Tape& tape = Tape::active();
+	double dt = this->myOption.T / static_cast<double>(this->NT);
+	double sqrtdt = std::sqrt(dt);
+	std::vector<double> increments(this->NT + 1), Z(this->NT);
+
+	for (long i = first; i <= last; ++i)
+	{
+		// Standard normal draws of the path, from its row of the Wiener matrix or regenerated
+		const double* row = nullptr;
+		if (this->incrementsStored())
+			row = this->dW.row(i);
+		else
+		{
+			pathIncrements(randGen, i, dt, increments.data());
+			row = increments.data();
+		}
+		for (long j = 0; j < this->NT; ++j)
+			Z[j] = row[j] / sqrtdt;
+
+		// Forward: the inputs, the path and its twin, the payoff and the discounting
+		tape.rewind();
+		Number spot(S), r(this->myOption.r), D(this->myOption.D), sigma(this->myOption.sigma), T(this->myOption.T);
+		Number average_plus, average_minus;
+		sde.generateAverages(spot, r, D, sigma, T, Z.data(), average_plus, average_minus);
+		Number value = 0.5 * (myOption.payoff(average_plus) + myOption.payoff(average_minus)) * exp(-r * T);
+
+		// Backward: all the derivatives of the sample at once
+		value.propagate();
+		double sample[SENSITIVITY_SAMPLES] = { value.value(), spot.adjoint(), sigma.adjoint(), r.adjoint(), -T.adjoint(), D.adjoint() };
+		for (long k = 0; k < SENSITIVITY_SAMPLES; ++k)
+			samples[k].add(sample[k]);
+	}
+}
+
+void MonteCarlo::pathIncrements(const RNG& randGen, long path, double dt, double* dW)
+{
+	// Regenerates the increments of one path, from its Sobol point in a quasi-random run
+	// and with W(T) in its stratum in a stratified run
+	if (this->quasiRandom)
+		this->sobol->generateWienerProcess(path, dt, dW);
+	else if (this->stratified)
+		this->stratifiedRNG->generateWienerProcess(path, dt, dW);
+	else
+		randGen.generateWienerProcess(path, dt, dW);
+}
+
+void MonteCarlo::loadIncrements(const RNG& randGen, long batch, long lanes, double* batch_dW, std::vector<double>& increments)
+{
+	// Puts the increments of paths batch, ..., batch + lanes - 1 in the lanes of batch_dW (see SDEBatch::loadLanes),
+	// from the Wiener matrix or regenerated into increments, the same values as the rows of the matrix
+	double dt = this->myOption.T / static_cast<double>(this->NT);
+	SDEBatch::loadLanes([&](long path)
+	{
+		if (this->incrementsStored())
+			return static_cast<const double*>(this->dW.row(path));
+		pathIncrements(randGen, path, dt, increments.data());
+		return static_cast<const double*>(increments.data());
+	}, batch, lanes, this->NT, batch_dW);
+}
+
 void MonteCarlo::generatePrices(double Smin, double Smax, double dS)
 {
 	// Generates prices, standard error and standard deviation and adds to maps
@@ -101,14 +702,87 @@ void MonteCarlo::generatePrices(double Smin, double Smax, double dS)
 	StopWatch<> sw;
 	sw.Start();
 
-	// Loop through range of prices using dS as the jump
+	// Range of prices using dS as the jump
+	std::vector<double> spots;
 	for (double s = Smin; s <= Smax; s += dS)
+		spots.push_back(s);
+
+	if (this->streaming)
 	{
-		// Generate paths and add prices + standard deviation + standard error to a map
-		generatePaths(s);
-		prices.insert(std::pair<double, double>(s, this->option_price));
-		stddev.insert(std::pair<double, double>(s, this->SD));
-		stderror.insert(std::pair<double, double>(s, this->SE));
+		long nSpots = static_cast<long>(spots.size());
+		std::vector<double> spotPrices(nSpots), spotStdDev(nSpots), spotStdErr(nSpots);
+		if (this->spotScaling)
+		{
+			// Simulate once from 1 and scale the paths to every spot, with the Greeks in the same pass
+			std::vector<Estimate> spotEstimates, spotDeltas, spotGammas;
+			streamGrid(spots, greeksInPass(), spotEstimates, spotDeltas, spotGammas);
+			for (long k = 0; k < nSpots; ++k)
+			{
+				spotPrices[k] = spotEstimates[k].value;
+				spotStdDev[k] = spotEstimates[k].SD;
+				spotStdErr[k] = spotEstimates[k].SE;
+			}
+			for (long k = 0; k < static_cast<long>(spotDeltas.size()); ++k)
+			{
+				deltas.insert(std::pair<double, double>(spots[k], spotDeltas[k].value));
+				gammas.insert(std::pair<double, double>(spots[k], spotGammas[k].value));
+				deltaStdErr.insert(std::pair<double, double>(spots[k], spotDeltas[k].SE));
+				gammaStdErr.insert(std::pair<double, double>(spots[k], spotGammas[k].SE));
+			}
+		}
+		else
+		{
+			// Each spot is an independent task reading the shared Wiener matrix and writing its
+			// own slot of the result vectors. If there are fewer spots than threads, the spare
+			// threads are used for the simulations within each spot
+			unsigned spotThreads = (nSpots > 0 && static_cast<long>(this->nThreads) > nSpots) ?
+				this->nThreads / static_cast<unsigned>(nSpots) : 1;
+
+			// The drift shifts of importance sampling are chosen before, as the spots run at the same time
+			std::vector<double> spotShifts(nSpots, 0.0);
+			for (long k = 0; k < nSpots && this->importanceSampling; ++k)
+			{
+				spotShifts[k] = optimalShift(spots[k]);
+				driftShifts.insert(std::pair<double, double>(spots[k], spotShifts[k]));
+			}
+
+			parallelFor(nSpots, this->nThreads, [&](long k)
+			{
+				streamPaths(spots[k], spotShifts[k], spotThreads, spotPrices[k], spotStdDev[k], spotStdErr[k]);
+			});
+		}
+
+		// Add prices + standard deviation + standard error to a map
+		for (long k = 0; k < nSpots; ++k)
+		{
+			prices.insert(std::pair<double, double>(spots[k], spotPrices[k]));
+			stddev.insert(std::pair<double, double>(spots[k], spotStdDev[k]));
+			stderror.insert(std::pair<double, double>(spots[k], spotStdErr[k]));
+		}
+
+		// The last spot is the current price, as when looping through the spots one by one
+		if (nSpots > 0)
+		{
+			this->option_price = spotPrices[nSpots - 1];
+			this->SD = spotStdDev[nSpots - 1];
+			this->SE = spotStdErr[nSpots - 1];
+		}
+	}
+	else
+	{
+		// Loop through range of prices, storing all the paths for each price
+		for (double s : spots)
+		{
+			// Generate paths and add prices + standard deviation + standard error to a map
+			generatePaths(s);
+			prices.insert(std::pair<double, double>(s, this->option_price));
+			stddev.insert(std::pair<double, double>(s, this->SD));
+			stderror.insert(std::pair<double, double>(s, this->SE));
+			if ((this->controlVariate && this->myOption.style == 1) || this->stratified)
+				varianceReduction.insert(std::pair<double, double>(s, this->variance_reduction));
+			if (this->importanceSampling)
+				driftShifts.insert(std::pair<double, double>(s, this->drift_shift));
+		}
 	}
 
 	// Return time elapsed
@@ -116,30 +790,147 @@ void MonteCarlo::generatePrices(double Smin, double Smax, double dS)
 	this->time_elapsed = sw.GetTime();
 }
 
+long MonteCarlo::gridSums() const
+{
+	return GRID_SUMS + (this->stratified ? 2 * this->strata : 0);
+}
+
+bool MonteCarlo::greeksInPass() const
+{
+	// The estimators of the spot scaling pass when asked for, and always on a grid of fewer than 3 spots,
+	// which is too small for the finite differences (a single spot would get no Greeks at all)
+	if (!(this->streaming && this->spotScaling))
+		return false;
+	long nSpots = 0;
+	for (double s = this->Smin; s <= this->Smax; s += this->dS)
+		++nSpots;
+	return this->pathwiseGreeks || nSpots < 3;
+}
+
 // Calculation functions
 void MonteCarlo::calculatePrice()
 {
 	// Initialise and define variables 
-	double payoffT;
-	double sumPriceT = 0.0; 
-	double squaredPayoffT = 0.0;
-	
-	// Convert number of simulations to double for division later on
-	double MC = static_cast<double>(this->M);
+	double payoffT, controlT;
+	Accumulator payoffs;
+	PairAccumulator controlled;
+
+	// An arithmetic Asian price is corrected with the geometric average of the exact path on the 
+	// same increments, as in streamGrid
+	bool control = this->controlVariate && this->myOption.style == 1;
+	double S = this->paths_plus.row(0)[0];
+	double dt = myOption.T / static_cast<double>(this->NT);
+	double logDrift = (myOption.r - myOption.D - 0.5 * myOption.sigma * myOption.sigma + myOption.sigma * this->drift_shift) * dt;
+	double n = static_cast<double>(this->NT + 1);
+
+	// Paths made with a drift shift (importance sampling) are weighted by their likelihood ratios,
+	// exp(-shift W(T) - shift^2 T/2) and exp(shift W(T) - shift^2 T/2) for the twin
+	double shift = this->drift_shift;
+	double weightPlus = 1.0, weightMinus = 1.0;
+
+	// Payoffs of each stratum in a stratified run
+	std::vector<Accumulator> strata(this->stratified ? this->strata : 0);
 
 	// Loop through number of simulations, calculate payoff in OptionData
-	for (long i = 1; i < this->M; i++)
+	for (long i = 0; i < this->M; i++)
 	{
+		const double* row = this->dW.row(i + 1);
+		if (shift != 0.0)
+		{
+			double W = 0.0;
+			for (long j = 0; j < this->NT; ++j)
+				W += row[j];
+			weightPlus = std::exp(-shift * W - 0.5 * shift * shift * myOption.T);
+			weightMinus = std::exp(shift * W - 0.5 * shift * shift * myOption.T);
+		}
+
 		// Send the entire path into myOption, there the price will be calculated whether
 		// the option is pathwise dependent (e.g. Asian) or not (e.g. European)
-		payoffT = 0.5 * (myOption.payoff(this->paths_plus[i]) + myOption.payoff(this->paths_minus[i]));
-		sumPriceT += payoffT;
-		squaredPayoffT += (payoffT * payoffT);
+		payoffT = 0.5 * (myOption.payoff(this->paths_plus.row(i), this->NT + 1) * weightPlus + myOption.payoff(this->paths_minus.row(i), this->NT + 1) * weightMinus);
+		payoffs.add(payoffT);
+		if (this->stratified)
+			strata[this->stratifiedRNG->stratum(i + 1)].add(payoffT);
+
+		if (control)
+		{
+			// Running log prices of the path and its twin and their sums
+			double logPlus = std::log(S), logMinus = std::log(S);
+			double sumPlus = logPlus, sumMinus = logMinus;
+			for (long j = 0; j < this->NT; ++j)
+			{
+				logPlus += logDrift + myOption.sigma * row[j];
+				logMinus += logDrift - myOption.sigma * row[j];
+				sumPlus += logPlus;
+				sumMinus += logMinus;
+			}
+			controlT = 0.5 * (myOption.payoff(std::exp(sumPlus / n)) * weightPlus + myOption.payoff(std::exp(sumMinus / n)) * weightMinus);
+			controlled.add(controlT, payoffT);
+		}
 	}
-	// Calculate standard deviation, standard error and option price
-	this->option_price = std::exp(-myOption.r * myOption.T) * sumPriceT / MC;
-	this->SD = std::sqrt((squaredPayoffT / MC) - (sumPriceT * sumPriceT) / (MC * MC));
-	this->SE = this->SD / std::sqrt(M);
+
+	Estimate e;
+	double discount = std::exp(-myOption.r * myOption.T);
+	if (control)
+		e = controlledEstimate(controlled, geometricControlMean(S), discount, this->variance_reduction);
+	else if (this->stratified)
+		e = stratifiedEstimate(strata, payoffs, discount, this->variance_reduction);
+	else
+		e = estimate(payoffs, discount);
+
+	// Option price, standard deviation and standard error
+	this->option_price = e.value;
+	this->SD = e.SD;
+	this->SE = e.SE;
+}
+double MonteCarlo::optimalShift(double S)
+{
+	// Drift of the Brownian motion for importance sampling at spot S: the theta that maximises
+	// log payoff - theta^2 T/2 over the straight paths W(t) = theta t (Glasserman, Heidelberger and
+	// Shahabuddin, 1999), with the terminal price (European) or the geometric average of the path 
+	// (Asian) as the underlying. On such a path the underlying is x = S exp(c (m + sigma theta) T) with
+	// c = 1 or 1/2, and the objective is concave where the payoff is positive, so its derivative
+	// d b x / payoff - theta T (b = c sigma T, d = 1 for a call and -1 for a put) has one root there
+	double m = myOption.r - myOption.D - 0.5 * myOption.sigma * myOption.sigma;
+	double c = (myOption.style == 0) ? 1.0 : 0.5;
+	double b = c * myOption.sigma * myOption.T;
+	double d = (myOption.type == 'C' || myOption.type == 'c') ? 1.0 : -1.0;
+	auto slope = [&](double theta)
+	{
+		double x = S * std::exp(c * (m + myOption.sigma * theta) * myOption.T);
+		return d * b * x / myOption.payoff(x) - theta * myOption.T;
+	};
+
+	// The payoff is positive on the side d of theta0, where the underlying is at the strike. Walk out
+	// from theta0 until the objective stops rising (d times the slope turns negative), then bisect
+	double theta0 = (std::log(myOption.K / S) / (c * myOption.T) - m) / myOption.sigma;
+	double inner = 0.0, outer = 1.0 / std::sqrt(myOption.T);
+	while (d * slope(theta0 + d * outer) > 0.0)
+	{
+		inner = outer;
+		outer *= 2.0;
+	}
+	for (int i = 0; i < 100; ++i)
+	{
+		double middle = 0.5 * (inner + outer);
+		if (d * slope(theta0 + d * middle) > 0.0)
+			inner = middle;
+		else
+			outer = middle;
+	}
+	return theta0 + d * 0.5 * (inner + outer);
+}
+double MonteCarlo::geometricControlMean(double S)
+{
+	// Undiscounted expectation of the payoff of the geometric average of the NT + 1 prices at spot S,
+	// from the closed form of the discretely monitored geometric Asian option
+	double growth = std::exp(myOption.r * myOption.T);
+	if (myOption.type == 'C' || myOption.type == 'c')
+	{
+		DiscreteGeometricAsianCallPrice price(myOption.K, myOption.T, myOption.r, myOption.D, myOption.sigma, this->NT);
+		return growth * price.execute(S);
+	}
+	DiscreteGeometricAsianPutPrice price(myOption.K, myOption.T, myOption.r, myOption.D, myOption.sigma, this->NT);
+	return growth * price.execute(S);
 }
 double MonteCarlo::maxPricingError()
 {
@@ -234,39 +1025,3 @@ std::ostream& operator<<(std::ostream& os, const MonteCarlo& MC)
 	os << MC.Smin << ", " << MC.Smax << ", " << MC.myOption.K<< ", " << MC.myOption << ", " << MC.NT << ", " << MC.M << ")";
 	return os;
 }
-
-/* -----------------------------------------------
-	Helper functions for normal cdf inverse from
-	https://www.johndcook.com/blog/cpp_phi_inverse/
--------------------------------------------------*/
-
-double RationalApproximation(double t)
-{
-	// Abramowitz and Stegun formula 26.2.23.
-	// The absolute value of the error should be less than 4.5 e-4.
-	double c[] = { 2.515517, 0.802853, 0.010328 };
-	double d[] = { 1.432788, 0.189269, 0.001308 };
-	return t - ((c[2] * t + c[1]) * t + c[0]) / (((d[2] * t + d[1]) * t + d[0]) * t + 1.0);
-}
-
-double NormalCDFInverse(double p)
-{
-	if (p <= 0.0 || p >= 1.0)
-	{
-		std::stringstream os;
-		os << "Invalid input argument (" << p
-			<< "); must be larger than 0 but less than 1.";
-		throw std::invalid_argument(os.str());
-	}
-
-	if (p < 0.5)
-	{
-		// F^-1(p) = - G^-1(p)
-		return -RationalApproximation(sqrt(-2.0 * log(p)));
-	}
-	else
-	{
-		// F^-1(p) = G^-1(1-p)
-		return RationalApproximation(sqrt(-2.0 * log(1 - p)));
-	}
-}
\ No newline at end of file
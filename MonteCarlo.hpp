@@ -16,35 +16,93 @@
 #include "OptionData.hpp"
 #include "StopWatch.cpp"
 #include "SDE.hpp"
+#include "SDEBatch.hpp"
 #include "RNG.hpp"
+#include "Sobol.hpp"
+#include "StratifiedRNG.hpp"
 #include "FDM.hpp"
 #include "FairValue.hpp"
+#include "Parallel.hpp"
+#include "NormalDistribution.hpp"
+#include "Matrix.hpp"
+#include "AAD.hpp"
+#include "Accumulator.hpp"
 
-double RationalApproximation(double t);
-double NormalCDFInverse(double p);
 
 /* ABOUT
 	- stores the option data and performs Monte Carlo simulations*/
 
+// Discounted price and its sensitivities to the option data at one spot, from one AAD sweep per path
+struct Sensitivities
+{
+	Estimate price, delta, vega, rho, theta, dividend;	// theta = -dV/dT, dividend = dV/dD
+};
+
+// Statistics of the samples of a grid of spots, element [k] for spot k: the price, delta, gamma, the
+// pairs of geometric control and price, and in a stratified run the price within each stratum, 
+// element [s * nSpots + k] for stratum s
+struct GridStatistics
+{
+	std::vector<Accumulator> price, delta, gamma, strata;
+	std::vector<PairAccumulator> controlled;
+};
+
 class MonteCarlo
 {
 private:
-	double S0, SD, SE, Smin, Smax, dS, option_price, time_elapsed, accuracy, alpha;
+	double S0, SD, SE, Smin, Smax, dS, option_price, time_elapsed, accuracy, alpha, variance_reduction, drift_shift;
 	long NT, M;
+	long batchSize, minBatches, maxSimulations;	// Adaptive runs: simulations per batch, batches before stopping, cap on M
+	long replications;	// Quasi-random runs: number of independently scrambled replications
+	long strata;	// Stratified runs: number of equally likely strata of W(T)
+	unsigned nThreads;	// Number of worker threads used by the simulation engine
+	uint32_t seed;		// Seed of the counter-based random number generator
 	int SDE_type;	// 0 for Euler, 1 for exact simulation 
 	int style;		// 0 for European, 1 for Arithmetic Asian, 2 for Geometric Asian
+	int momentMatching;	// 0 for none, 1 to match the mean and variance of each time step, 2 of W(T) (stored increments only)
+	bool streaming;	// true to price each path as it is generated, false to store all the paths
+	bool storeIncrements;	// true to store the Wiener matrix, false to regenerate each path's increments when needed
+	bool spotScaling;	// true to stream the paths once from 1 and scale them to every spot (streaming only)
+	bool pathwiseGreeks;	// true to estimate delta and gamma in the same pass as the price (spot scaling only), false for finite differences on grids of 3 or more spots
+	bool adjointSensitivities;	// true to work out the sensitivities at S0 with AAD after the prices
+	bool controlVariate;	// true to use the geometric average of each path as a control variate (arithmetic Asian only)
+	bool adaptive;	// true to add batches of simulations until the confidence interval is within accuracy (spot scaling only)
+	bool quasiRandom;	// true to use scrambled Sobol points with a Brownian bridge instead of pseudo-random numbers (spot scaling only)
+	bool importanceSampling;	// true to shift the drift of the Brownian motion towards the payoff at each spot (no spot scaling)
+	bool stratified;	// true to stratify the terminal value of the Brownian motion, see StratifiedRNG (not with per spot streaming)
 	OptionData myOption;
 	FairValue fairOption;
-	std::vector<std::vector<double>> dW, paths_plus, paths_minus;
-	std::map<double, double> stddev, stderror, prices, deltas, gammas;
+	Matrix dW, paths_plus, paths_minus;		// One row per path, see Matrix
+	std::shared_ptr<const Sobol> sobol;		// Generator of the quasi-random runs, made by run()
+	std::shared_ptr<const StratifiedRNG> stratifiedRNG;	// Generator of the stratified runs, made by run()
+	std::map<double, double> stddev, stderror, prices, deltas, gammas, deltaStdErr, gammaStdErr, varianceReduction, driftShifts;
+	Sensitivities sensitivities;
+
+	// true if the increments are read from the Wiener matrix, an adaptive run regenerates them as M is not known up front
+	bool incrementsStored() const { return (this->storeIncrements && !this->adaptive) || !this->streaming; }
+
+	// Number of sums kept per spot by the grid blocks, with the payoff sums of each stratum in a stratified run
+	long gridSums() const;
+
+	// true if delta and gamma come from the estimators of the spot scaling pass, see pathwiseGreeks
+	bool greeksInPass() const;
 
 public:
 	// Constructor and destructors
-	MonteCarlo(const MonteCarlo& MC) : S0(MC.S0), SD(MC.SE), SE(MC.SE), Smin(MC.Smin), Smax(MC.Smax),
+	MonteCarlo(const MonteCarlo& MC) : S0(MC.S0), SD(MC.SD), SE(MC.SE), Smin(MC.Smin), Smax(MC.Smax),
 		dS(MC.dS), option_price(MC.option_price), time_elapsed(MC.time_elapsed), accuracy(MC.accuracy),
-		alpha(MC.alpha), NT(MC.NT), M(MC.M), SDE_type(MC.SDE_type), style(MC.style), myOption(MC.myOption), 
-		fairOption(MC.fairOption), dW(MC.dW), paths_plus(MC.paths_plus), paths_minus(MC.paths_minus), 
-		stddev(MC.stddev), stderror(MC.stderror), prices(MC.prices), deltas(MC.deltas), gammas(MC.gammas)
+		alpha(MC.alpha), variance_reduction(MC.variance_reduction), drift_shift(MC.drift_shift), NT(MC.NT), M(MC.M), 
+		batchSize(MC.batchSize), minBatches(MC.minBatches), maxSimulations(MC.maxSimulations), 
+		replications(MC.replications), strata(MC.strata), nThreads(MC.nThreads), seed(MC.seed), 
+		SDE_type(MC.SDE_type), style(MC.style), momentMatching(MC.momentMatching), streaming(MC.streaming), 
+		storeIncrements(MC.storeIncrements), spotScaling(MC.spotScaling), pathwiseGreeks(MC.pathwiseGreeks), 
+		adjointSensitivities(MC.adjointSensitivities), controlVariate(MC.controlVariate), adaptive(MC.adaptive), 
+		quasiRandom(MC.quasiRandom), importanceSampling(MC.importanceSampling), stratified(MC.stratified), 
+		myOption(MC.myOption), fairOption(MC.fairOption), dW(MC.dW), paths_plus(MC.paths_plus), 
+		paths_minus(MC.paths_minus), sobol(MC.sobol), stratifiedRNG(MC.stratifiedRNG), stddev(MC.stddev), 
+		stderror(MC.stderror), prices(MC.prices), deltas(MC.deltas), gammas(MC.gammas), deltaStdErr(MC.deltaStdErr), 
+		gammaStdErr(MC.gammaStdErr), varianceReduction(MC.varianceReduction), driftShifts(MC.driftShifts), 
+		sensitivities(MC.sensitivities)
 	{
 		// Create instance of the Black Scholes data structure
 		FairValue FV(MC.myOption, MC.Smin, MC.Smax, MC.dS);
@@ -52,9 +110,13 @@ public:
 	}
 
 	MonteCarlo(const OptionData& OD, double Smin, double Smax, double dS, long NT, long M, 
-		double alpha, double accuracy, int SDE_type, int style) : myOption(OD), S0(0.0), SD(0.0), SE(0.0), 
-		Smin(Smin), Smax(Smax), dS(dS), option_price(0.0), time_elapsed(0.0), NT(NT), M(M), alpha(alpha), 
-		accuracy(accuracy), SDE_type(SDE_type), style(style) {}
+		double alpha, double accuracy, int SDE_type, int style) : S0(0.0), SD(0.0), SE(0.0), 
+		Smin(Smin), Smax(Smax), dS(dS), option_price(0.0), time_elapsed(0.0), accuracy(accuracy), alpha(alpha), 
+		variance_reduction(1.0), drift_shift(0.0), NT(NT), M(M), batchSize(16384), minBatches(2), 
+		maxSimulations(10000000), replications(16), strata(32), nThreads(defaultNumberOfThreads()), seed(0), 
+		SDE_type(SDE_type), style(style), momentMatching(0), streaming(true), storeIncrements(true), 
+		spotScaling(true), pathwiseGreeks(false), adjointSensitivities(false), controlVariate(false), adaptive(false), 
+		quasiRandom(false), importanceSampling(false), stratified(false), myOption(OD), sensitivities() {}
 
 	// Set functions
 	void setInitialPrice(double S);
@@ -64,6 +126,24 @@ public:
 	void setNumberOfSteps(long NT);
 	void setNumberOfSimulations(long M);
 	void setOptionData(const OptionData& op);
+	void setStreaming(bool streaming);
+	void setNumberOfThreads(unsigned nThreads);
+	void setSeed(uint32_t seed);
+	void setStoreIncrements(bool storeIncrements);
+	void setSpotScaling(bool spotScaling);
+	void setPathwiseGreeks(bool pathwiseGreeks);
+	void setAdjointSensitivities(bool adjointSensitivities);
+	void setControlVariate(bool controlVariate);
+	void setAdaptive(bool adaptive);
+	void setBatchSize(long batchSize);
+	void setMinBatches(long minBatches);
+	void setMaxSimulations(long maxSimulations);
+	void setQuasiRandom(bool quasiRandom);
+	void setReplications(long replications);
+	void setImportanceSampling(bool importanceSampling);
+	void setStratified(bool stratified);
+	void setStrata(long strata);
+	void setMomentMatching(int momentMatching);
 	
 	// Get functions
 	double getOptionPrice();
@@ -73,14 +153,37 @@ public:
 	double getTimeElapsed();
 	long getNumberOfTimeSteps();
 	long getNumberOfSimulations();
+	unsigned getNumberOfThreads();
+	uint32_t getSeed();
+	bool getStoreIncrements();
+	bool getSpotScaling();
+	bool getPathwiseGreeks();
+	bool getAdjointSensitivities();
+	bool getControlVariate();
+	bool getAdaptive();
+	long getBatchSize();
+	long getMinBatches();
+	long getMaxSimulations();
+	bool getQuasiRandom();
+	long getReplications();
+	bool getImportanceSampling();
+	bool getStratified();
+	long getStrata();
+	int getMomentMatching();
+	Sensitivities getSensitivities();	// At S0, from the last run with adjoint sensitivities
 	int getSDEtype();
+	bool getStreaming();
 	char getOptionType();
 	FairValue getFairOption();
-	std::map<double, double> getStdDev();	// Stock price, standard deviation
+	std::map<double, double> getStdDev();	// Stock price, standard deviation (within the strata in a stratified run)
 	std::map<double, double> getStdErr();	// Stock price, standard error
 	std::map<double, double> getPrices();	// Stock price, option price
-	std::map<double, double> getDeltas();	// Stock price, option delta
-	std::map<double, double> getGammas();	// Stock price, option gamma
+	std::map<double, double> getDeltas();	// Stock price, option delta, empty for fewer than 3 spots without spot scaling
+	std::map<double, double> getGammas();	// Stock price, option gamma, empty for fewer than 3 spots without spot scaling
+	std::map<double, double> getDeltaStdErr();	// Stock price, standard error of the delta (Greeks from the same pass only, see pathwiseGreeks)
+	std::map<double, double> getGammaStdErr();	// Stock price, standard error of the gamma (Greeks from the same pass only, see pathwiseGreeks)
+	std::map<double, double> getDriftShifts();	// Stock price, drift of the Brownian motion used (importance sampling only)
+	std::map<double, double> getVarianceReduction();	// Stock price, variance of the plain estimator over that of the controlled (control variate) or stratified one
 
 	// Main functions
 	void run();
@@ -88,12 +191,25 @@ public:
 
 	// Generate functions
 	void generatePaths(double S);
+	void streamPaths(double S);
+	void streamPaths(double S, double shift, unsigned nThreads, double& price, double& SD, double& SE);
+	void streamBlock(double S, double shift, long first, long last, Accumulator& payoffs);
+	void streamGrid(const std::vector<double>& spots, bool greeks, std::vector<Estimate>& prices, std::vector<Estimate>& deltas, std::vector<Estimate>& gammas);
+	void gridEstimates(const std::vector<double>& spots, bool greeks, const GridStatistics& statistics, std::vector<Estimate>& prices, std::vector<Estimate>& deltas, std::vector<Estimate>& gammas);
+	void streamGridSums(const std::vector<double>& spots, bool greeks, long first, long last, GridStatistics& statistics);
+	void streamGridBlock(const std::vector<double>& spots, bool greeks, long first, long last, double* sums, double* shifts);
+	void calculateSensitivities(double S);
+	void sensitivityBlock(double S, long first, long last, Accumulator* samples);
+	void pathIncrements(const RNG& randGen, long path, double dt, double* dW);
+	void loadIncrements(const RNG& randGen, long batch, long lanes, double* batch_dW, std::vector<double>& increments);
 	void generatePrices(double Smin, double Smax, double dS);
 	//void generateDeltas();
 	//void generateGammas();
 
 	// Calculation functions
 	void calculatePrice();
+	double geometricControlMean(double S);
+	double optimalShift(double S);
 	double maxPricingError();
 	double maxStandardError();
 	double maxStandardDeviation();
@@ -0,0 +1,41 @@
+#include "NormalDistribution.hpp"
+#include "InstructionSet.hpp"
+#include <sstream>
+#include <stdexcept>
+
+// Baseline copies of the array kernels, built with the project's default instruction set
+#define KERNEL_SUFFIX Baseline
+#include "NormalKernels.inl"
+
+double NormalCDF(double x)
+{
+	return batchNormalCDF(x);
+}
+
+double NormalCDFInverse(double p)
+{
+	if (p <= 0.0 || p >= 1.0)
+	{
+		std::stringstream os;
+		os << "Invalid input argument (" << p
+			<< "); must be larger than 0 but less than 1.";
+		throw std::invalid_argument(os.str());
+	}
+	return batchNormalCDFInverse(p);
+}
+
+void normalCDF(const double* x, long n, double* result)
+{
+	// Kernel for the instruction set of this CPU
+	static const NormalArrayKernel kernel = (instructionSetInUse() == InstructionSet::AVX512) ? normalCDFAVX512 :
+		((instructionSetInUse() == InstructionSet::AVX2) ? normalCDFAVX2 : normalCDFBaseline);
+	kernel(x, n, result);
+}
+
+void normalCDFInverse(const double* p, long n, double* result)
+{
+	// Kernel for the instruction set of this CPU
+	static const NormalArrayKernel kernel = (instructionSetInUse() == InstructionSet::AVX512) ? normalCDFInverseAVX512 :
+		((instructionSetInUse() == InstructionSet::AVX2) ? normalCDFInverseAVX2 : normalCDFInverseBaseline);
+	kernel(p, n, result);
+}
@@ -0,0 +1,24 @@
+#ifndef NORMAL_DISTRIBUTION_HPP
+#define NORMAL_DISTRIBUTION_HPP
+
+/* ABOUT
+	- Standard normal distribution function N and its inverse
+	- The array versions run the vectorised kernels of the CPU's instruction set, for inverse
+	  transform sampling of many uniforms at once (quasi-random and stratified sampling) and
+	  for evaluating closed form prices over a grid
+	- Near double precision relative to min(N, 1 - N): Cody's approximations for N, Acklam's 
+	  approximation with one Halley step for the inverse (see BatchMath.hpp)*/
+
+// N(x)
+double NormalCDF(double x);
+
+// N^-1(p), throws std::invalid_argument unless 0 < p < 1
+double NormalCDFInverse(double p);
+
+// result[i] = N(x[i]) for i = 0, ..., n - 1
+void normalCDF(const double* x, long n, double* result);
+
+// result[i] = N^-1(p[i]) for i = 0, ..., n - 1, all p[i] in (0,1) and not subnormal
+void normalCDFInverse(const double* p, long n, double* result);
+
+#endif // !NORMAL_DISTRIBUTION_HPP
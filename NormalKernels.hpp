@@ -0,0 +1,20 @@
+#ifndef NORMAL_KERNELS_HPP
+#define NORMAL_KERNELS_HPP
+
+/* ABOUT
+	- Declarations of the array kernels of the standard normal distribution function and its
+	  inverse, one copy per instruction set, see NormalDistribution.hpp for the public functions
+	- result[i] = N(x[i]) and result[i] = N^-1(p[i]) for i = 0, ..., n - 1*/
+
+// Signature of the array kernels
+typedef void (*NormalArrayKernel)(const double* x, long n, double* result);
+
+// Kernels for each instruction set
+void normalCDFBaseline(const double* x, long n, double* result);
+void normalCDFAVX2(const double* x, long n, double* result);
+void normalCDFAVX512(const double* x, long n, double* result);
+void normalCDFInverseBaseline(const double* p, long n, double* result);
+void normalCDFInverseAVX2(const double* p, long n, double* result);
+void normalCDFInverseAVX512(const double* p, long n, double* result);
+
+#endif // !NORMAL_KERNELS_HPP
@@ -0,0 +1,29 @@
+// NormalKernels.inl
+//
+// Bodies of the normal distribution array kernels, included by NormalDistribution.cpp, Kernels_avx2.cpp
+// and Kernels_avx512.cpp with KERNEL_SUFFIX set to the instruction set, so each file defines its own copy.
+
+#ifndef KERNEL_SUFFIX
+#error "Define KERNEL_SUFFIX before including NormalKernels.inl"
+#endif
+
+#include "NormalKernels.hpp"
+#include "BatchMath.hpp"
+
+#define NORMAL_KERNEL_CONCAT(name, suffix) name##suffix
+#define NORMAL_KERNEL_NAME(name, suffix) NORMAL_KERNEL_CONCAT(name, suffix)
+
+void NORMAL_KERNEL_NAME(normalCDF, KERNEL_SUFFIX)(const double* x, long n, double* result)
+{
+	for (long i = 0; i < n; ++i)
+		result[i] = batchNormalCDF(x[i]);
+}
+
+void NORMAL_KERNEL_NAME(normalCDFInverse, KERNEL_SUFFIX)(const double* p, long n, double* result)
+{
+	for (long i = 0; i < n; ++i)
+		result[i] = batchNormalCDFInverse(p[i]);
+}
+
+#undef NORMAL_KERNEL_NAME
+#undef NORMAL_KERNEL_CONCAT
@@ -27,8 +27,10 @@
 #include <cmath>
 #include <algorithm>
 
-// C++11 supports the error function
-auto cndN = [](double x) { return 0.5 * (1.0 - std::erf(-x / std::sqrt(2.0))); };
+#include "BatchMath.hpp"
+
+// Cumulative normal distribution, without a call to std::erf (see BatchMath.hpp)
+auto cndN = [](double x) { return batchNormalCDF(x); };
 
 /*	ABOUT
 	- Calculates fair price/delta/gamma for comparison purposes using an inheritance hierarchy
@@ -388,6 +390,56 @@ public:
 	}
 };
 
+// ------------------------------------------------------------------------
+// Closed form solutions for discretely monitored geometric Asian options
+// ------------------------------------------------------------------------
+// Geometric average of the NT + 1 prices S(0), S(dt), ..., S(T) as in the Monte Carlo simulation,
+// lognormal with log mean log(S) + (r - b - sig^2/2) T/2 and variance sig^2 T (2 NT + 1)/(6 (NT + 1)).
+// Exact expectations of the simulated geometric payoffs, used by the control variate in MonteCarlo
+class DiscreteGeometricAsianCallPrice final : public OptionCommand
+{
+private:
+	long NT;
+
+public:
+	explicit DiscreteGeometricAsianCallPrice(double strike, double expiration, double riskFree, double costOfCarry, double volatility, long NT)
+		: OptionCommand(strike, expiration, riskFree, costOfCarry, volatility), NT(NT) {}
+
+	virtual ~DiscreteGeometricAsianCallPrice() {};
+
+	virtual double execute(double S) override
+	{
+		double m = log(S) + (r - b - 0.5 * sig * sig) * 0.5 * T;
+		double v = sig * sig * T * (2.0 * NT + 1.0) / (6.0 * (NT + 1.0));
+		double d1 = (m - log(K) + v) / sqrt(v);
+		double d2 = d1 - sqrt(v);
+
+		return std::exp(-r * T) * (std::exp(m + 0.5 * v) * N(d1) - K * N(d2));
+	}
+};
+
+class DiscreteGeometricAsianPutPrice final : public OptionCommand
+{
+private:
+	long NT;
+
+public:
+	explicit DiscreteGeometricAsianPutPrice(double strike, double expiration, double riskFree, double costOfCarry, double volatility, long NT)
+		: OptionCommand(strike, expiration, riskFree, costOfCarry, volatility), NT(NT) {}
+
+	virtual ~DiscreteGeometricAsianPutPrice() {};
+
+	virtual double execute(double S) override
+	{
+		double m = log(S) + (r - b - 0.5 * sig * sig) * 0.5 * T;
+		double v = sig * sig * T * (2.0 * NT + 1.0) / (6.0 * (NT + 1.0));
+		double d1 = (m - log(K) + v) / sqrt(v);
+		double d2 = d1 - sqrt(v);
+
+		return std::exp(-r * T) * (K * N(-d2) - std::exp(m + 0.5 * v) * N(-d1));
+	}
+};
+
 // ----------------------------------------------------------------
 // Closed form solutions for European option prices, deltas, gammas
 // ----------------------------------------------------------------
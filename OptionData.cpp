@@ -28,27 +28,22 @@ std::ostream& operator<<(std::ostream& os, const OptionData& op)
 	return os;
 }
 
-double OptionData::payoff(std::vector<double> path)
+double OptionData::payoff(const std::vector<double>& path)
+{
+	return payoff(path.data(), static_cast<long>(path.size()));
+}
+
+double OptionData::payoff(const double* path, long n)
 { 
 	// Payoff function
 	// TODO: Barrier options
 	// - tuple, min, max, 0 by default
 	// - knock in, out, etc ...
 
-	double S = 0.0, P;
-	if (style == 0)		// European option
-		S = path.back();
-	else if(style == 1)	// Arithmetic Asian option
-		S = std::accumulate(path.begin(), path.end(), 0) / static_cast<double>(path.size());
-	else if(style == 2) // Geometric Asian option
-	{
-		long double geo_sum = path[0];
-		for (int i = 1; i < path.size(); i++)
-		{
-			geo_sum = geo_sum * path[i];
-		}
-		S = pow(geo_sum, 1.0 / static_cast<double>(path.size()));
-	}
+	// Average the path in a single pass
+	PayoffAccumulator acc(this->style);
+	for (long i = 0; i < n; i++)
+		acc.add(path[i]);
 
 	/* TODO: Add barrier option functionality
 		- Implement the four main types
@@ -75,10 +70,44 @@ double OptionData::payoff(std::vector<double> path)
 	  
 	  bool barrierHit = false;*/
 
+	return payoff(acc.average());
+}
+
+double OptionData::payoff(double S)
+{
+	// Payoff of the averaged price S
+	double P;
 	if (type == 'C' || type == 'c')	
 		P = std::max(S - this->K, 0.0); // Call
 	else	
 		P = std::max(this->K - S, 0.0); // Put
 
 	return P;
+}
+
+// Payoff accumulator
+void PayoffAccumulator::reset()
+{
+	this->count = 0;
+	this->value = 0.0;
+}
+
+void PayoffAccumulator::add(double S)
+{
+	if (this->style == 1)		// Arithmetic Asian option, running sum
+		this->value += S;
+	else if (this->style == 2)	// Geometric Asian option, running sum of logs
+		this->value += std::log(S);
+	else						// European option, last price
+		this->value = S;
+	++this->count;
+}
+
+double PayoffAccumulator::average() const
+{
+	if (this->style == 1)
+		return this->value / static_cast<double>(this->count);
+	else if (this->style == 2)
+		return std::exp(this->value / static_cast<double>(this->count));
+	return this->value;
 }
\ No newline at end of file
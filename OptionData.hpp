@@ -82,10 +82,45 @@ struct OptionData
 	int getOptionType();
 
 	// Payoff calculations
-	double payoff(std::vector<double> path);
+	double payoff(const std::vector<double>& path);
+	double payoff(const double* path, long n);	// Path of n prices, e.g. a row of a path matrix
+	double payoff(double S);	// Payoff of the averaged (or final) price S of a path
+	template <typename Real> Real payoff(const Real& S) const;	// As above for any number type, e.g. Number (see AAD.hpp)
 
 	// Operator overloads
 	friend std::ostream & operator<<(std::ostream& os, const OptionData& op);
 };
 
+template <typename Real> 
+Real OptionData::payoff(const Real& S) const
+{
+	// Payoff of the averaged price S, as payoff(double)
+	if (type == 'C' || type == 'c')
+		return (S > this->K) ? S - this->K : Real(0.0);	// Call
+	return (S < this->K) ? this->K - S : Real(0.0);	// Put
+}
+
+/*	ABOUT
+	- Running average of a path for the payoff, updated as each price of the path is made
+	  and read once when the path is finished, so the path itself never has to be stored
+	- European: the last price, arithmetic Asian: running sum, geometric Asian: running sum
+	  of the logs (a running product overflows or underflows for long paths)*/
+struct PayoffAccumulator
+{
+	int style;		// Option style, see OptionData
+	long count;		// Number of prices added
+	double value;	// Last price, sum of the prices or sum of their logs
+
+	explicit PayoffAccumulator(int style) : style(style), count(0), value(0.0) {}
+
+	// Start a new path
+	void reset();
+
+	// Add the next price of the path
+	void add(double S);
+
+	// Price that goes into the payoff: last price, arithmetic or geometric average
+	double average() const;
+};
+
 #endif // !OPTION_DATA_HPP
\ No newline at end of file
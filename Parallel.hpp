@@ -0,0 +1,81 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+// Built-in header files
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/* ABOUT
+	- Simple fork/join loop used by the random number generator and the Monte Carlo engine
+	- Runs f(0), ..., f(n-1) on up to nThreads worker threads, each index exactly once
+	- The loop body should only write to data owned by its index (e.g. one slot of a
+	  pre-allocated vector), then no locking is needed and the results do not depend
+	  on the number of threads or on the order in which the indices were run
+	- If f throws, the remaining indices are skipped, all the threads are joined and the
+	  first exception is rethrown on the calling thread*/
+
+inline unsigned defaultNumberOfThreads()
+{
+	// Number of hardware threads, hardware_concurrency() may return 0 if unknown
+	unsigned n = std::thread::hardware_concurrency();
+	return (n == 0) ? 1 : n;
+}
+
+template <typename Function>
+void parallelFor(long n, unsigned nThreads, Function f)
+{
+	// Run on the calling thread if there is nothing to share
+	if (nThreads <= 1 || n <= 1)
+	{
+		for (long i = 0; i < n; ++i)
+			f(i);
+		return;
+	}
+	if (static_cast<long>(nThreads) > n)
+		nThreads = static_cast<unsigned>(n);
+
+	// Each worker takes the next index from a shared counter until all are done. An exception
+	// is kept for the calling thread and moves the counter past the end, so the others stop
+	std::atomic<long> next(0);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	auto worker = [&]()
+	{
+		try
+		{
+			for (long i = next++; i < n; i = next++)
+				f(i);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+			next = n;
+		}
+	};
+
+	// The calling thread works as well, the threads are joined before any exception is rethrown
+	std::vector<std::thread> threads;
+	threads.reserve(nThreads - 1);
+	try
+	{
+		for (unsigned t = 1; t < nThreads; ++t)
+			threads.emplace_back(worker);
+	}
+	catch (const std::system_error&)
+	{
+		// A thread could not be started: the threads already running finish the loop
+	}
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+#endif // !PARALLEL_HPP
@@ -0,0 +1,214 @@
+#include "Portfolio.hpp"
+#include "SDEBatch.hpp"
+#include "RNG.hpp"
+#include "Parallel.hpp"
+#include "StopWatch.cpp"
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Options of one style and type: the batch of a unit strike option and the spots S0 / K of the options
+struct PortfolioGroup
+{
+	int style;
+	char type;
+	SDEBatch batch;
+	std::vector<long> options;
+	std::vector<double> spots;
+};
+
+static void checkOption(const OptionData& option, const OptionData& first)
+{
+	// Same dynamics as the first option, a positive strike and a known type and style
+	bool call = (option.type == 'C' || option.type == 'c');
+	bool put = (option.type == 'P' || option.type == 'p');
+	if (option.S0 != first.S0 || option.r != first.r || option.D != first.D || option.sigma != first.sigma || option.T != first.T)
+	{
+		std::stringstream os;
+		os << "Options in a portfolio must share S0, r, D, sigma and T; got " << option << " and " << first;
+		throw std::invalid_argument(os.str());
+	}
+	if (option.K <= 0.0 || !(call || put) || option.style < 0 || option.style > 2)
+	{
+		std::stringstream os;
+		os << "Invalid option in a portfolio (strike " << option.K << ", type " << option.type << ", style " << option.style << ")";
+		throw std::invalid_argument(os.str());
+	}
+}
+
+Portfolio::Portfolio(const std::vector<OptionData>& options, long NT, long M, int SDE_type) : NT(NT), M(M), 
+	SDE_type(SDE_type), nThreads(defaultNumberOfThreads()), seed(0), time_elapsed(0.0)
+{
+	for (const OptionData& option : options)
+		addOption(option);
+}
+
+void Portfolio::addOption(const OptionData& option)
+{
+	checkOption(option, this->options.empty() ? option : this->options.front());
+	this->options.push_back(option);
+}
+
+// Set functions
+void Portfolio::setNumberOfSteps(long NT) { this->NT = NT; }
+void Portfolio::setNumberOfSimulations(long M) { this->M = M; }
+void Portfolio::setNumberOfThreads(unsigned nThreads) { this->nThreads = (nThreads == 0) ? 1 : nThreads; }
+void Portfolio::setSeed(uint32_t seed) { this->seed = seed; }
+
+// Get functions
+long Portfolio::getNumberOfOptions() { return static_cast<long>(this->options.size()); }
+double Portfolio::getTimeElapsed() { return this->time_elapsed; }
+std::vector<OptionData> Portfolio::getOptions() { return this->options; }
+
+std::vector<Estimate> Portfolio::getEstimates()
+{
+	std::vector<Estimate> estimates;
+	for (std::size_t i = 0; i < this->payoffs.size(); ++i)
+	{
+		Estimate e;
+		e.value = std::exp(-this->options[i].r * this->options[i].T) * this->payoffs[i].getMean();
+		e.SD = this->payoffs[i].getStandardDeviation();
+		e.SE = this->payoffs[i].getStandardError();
+		estimates.push_back(e);
+	}
+	return estimates;
+}
+
+void Portfolio::run()
+{
+	if (this->options.empty() || this->NT < 1 || this->M < 1)
+	{
+		std::stringstream os;
+		os << "Invalid portfolio run (options, NT, M) = (" << this->options.size() << ", " << this->NT << ", " << this->M << ")";
+		throw std::invalid_argument(os.str());
+	}
+	StopWatch<> sw;
+	sw.Start();
+
+	// Blocks of the paths shared between the threads, with the payoff sums of every option and their shifts
+	long nOptions = static_cast<long>(this->options.size());
+	long nBlocks = (this->M + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK;
+	std::vector<double> blockSums(nBlocks * 3 * nOptions, 0.0);
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		long first = 1 + b * SDEBatch::PATHS_PER_BLOCK;
+		long last = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK);
+		double* sums = blockSums.data() + b * 3 * nOptions;
+		portfolioBlock(first, last, sums, sums + nOptions, sums + 2 * nOptions);
+	});
+
+	// Statistics of each block, merged in block order
+	this->payoffs.assign(nOptions, Accumulator());
+	for (long b = 0; b < nBlocks; ++b)
+	{
+		long n = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK) - b * SDEBatch::PATHS_PER_BLOCK;
+		const double* sums = blockSums.data() + b * 3 * nOptions;
+		for (long i = 0; i < nOptions; ++i)
+			this->payoffs[i].merge(Accumulator::fromSums(n, sums[i], sums[nOptions + i], sums[2 * nOptions + i]));
+	}
+
+	sw.Stop();
+	this->time_elapsed = sw.GetTime();
+}
+
+void Portfolio::portfolioBlock(long first, long last, double* sum, double* squared, double* shift) const
+{
+	// Groups of options with the same style and type, each with a unit strike batch, in order of style
+	const long L = SDEBatch::LANES;
+	long nOptions = static_cast<long>(this->options.size());
+	std::vector<PortfolioGroup> groups;
+	for (int style = 0; style <= 2; ++style)
+	{
+		for (char type : { 'C', 'P' })
+		{
+			OptionData unit(this->options.front());
+			unit.K = 1.0;
+			unit.type = type;
+			unit.style = style;
+			PortfolioGroup group{ style, type, SDEBatch(unit, this->SDE_type, this->NT), {}, {} };
+			for (long i = 0; i < nOptions; ++i)
+			{
+				const OptionData& option = this->options[i];
+				if (option.style == style && (option.type == type || option.type == type - 'A' + 'a'))
+				{
+					group.options.push_back(i);
+					group.spots.push_back(option.S0 / option.K);
+				}
+			}
+			if (!group.options.empty())
+				groups.push_back(group);
+		}
+	}
+
+	// Unit strike payoff sums of each group less its shifts, element [j] for its option j
+	std::vector<std::vector<double>> groupShift(groups.size()), groupSum(groups.size()), groupSquared(groups.size());
+	for (std::size_t g = 0; g < groups.size(); ++g)
+	{
+		groupShift[g].assign(groups[g].options.size(), 0.0);
+		groupSum[g].assign(groups[g].options.size(), 0.0);
+		groupSquared[g].assign(groups[g].options.size(), 0.0);
+	}
+	std::vector<double> zeros(nOptions, 0.0), unused(nOptions, 0.0);
+
+	// Buffers for one batch, as in MonteCarlo::streamBlock
+	RNG randGen(this->NT, this->M, this->seed);
+	double dt = this->options.front().T / static_cast<double>(this->NT);
+	std::vector<double> batch_dW(this->NT * L), increments(this->NT + 1);
+	SDEBatchPaths paths;
+
+	for (long batch = first; batch <= last; batch += L)
+	{
+		// Increments of the paths in their lanes, unused lanes get zeros
+		long lanes = std::min(L, last - batch + 1);
+		SDEBatch::loadBatchIncrements(randGen, batch, lanes, this->NT, dt, batch_dW.data(), increments.data());
+
+		// The averages of each style once, shared by its calls and puts, then every strike of the group
+		for (std::size_t g = 0; g < groups.size(); ++g)
+		{
+			if (g == 0 || groups[g].style != groups[g - 1].style)
+				groups[g].batch.generateAverages(1.0, batch_dW.data(), paths);
+			long nSpots = static_cast<long>(groups[g].spots.size());
+
+			// The shifts are the mean payoffs of the first batch, as in MonteCarlo::streamGridBlock
+			if (batch == first)
+			{
+				groups[g].batch.accumulateGrid(groups[g].spots.data(), nSpots, lanes, paths, zeros.data(), 
+					groupShift[g].data(), unused.data());
+				for (long j = 0; j < nSpots; ++j)
+					groupShift[g][j] /= static_cast<double>(lanes);
+			}
+			groups[g].batch.accumulateGrid(groups[g].spots.data(), nSpots, lanes, paths, groupShift[g].data(), 
+				groupSum[g].data(), groupSquared[g].data());
+		}
+	}
+
+	// Back to the strikes of the options
+	std::fill(sum, sum + nOptions, 0.0);
+	std::fill(squared, squared + nOptions, 0.0);
+	std::fill(shift, shift + nOptions, 0.0);
+	for (std::size_t g = 0; g < groups.size(); ++g)
+	{
+		for (std::size_t j = 0; j < groups[g].options.size(); ++j)
+		{
+			long i = groups[g].options[j];
+			double K = this->options[i].K;
+			sum[i] = K * groupSum[g][j];
+			squared[i] = K * K * groupSquared[g][j];
+			shift[i] = K * groupShift[g][j];
+		}
+	}
+}
+
+// Print functions
+std::ostream& operator<<(std::ostream& os, const Portfolio& portfolio)
+{
+	os << "type, style, strike, price, standard error\n";
+	for (std::size_t i = 0; i < portfolio.payoffs.size(); ++i)
+	{
+		const OptionData& option = portfolio.options[i];
+		os << option.type << ", " << option.style << ", " << option.K << ", " 
+			<< std::exp(-option.r * option.T) * portfolio.payoffs[i].getMean() << ", " << portfolio.payoffs[i].getStandardError() << "\n";
+	}
+	return os;
+}
@@ -0,0 +1,68 @@
+#ifndef PORTFOLIO_HPP
+#define PORTFOLIO_HPP
+
+// Built-in header files
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+// Custom header files
+#include "OptionData.hpp"
+#include "Accumulator.hpp"
+
+/* ABOUT
+	- Prices a book of options on one underlying from a single set of simulated paths
+	- The options may differ in strike, type (call or put) and style (European, arithmetic or geometric
+	  Asian) but must share the dynamics of the underlying: S0, r, D, sigma and T
+	- Each batch of increments is made once and turned into the averages of each style in the book
+	  (at most three passes of the scheme), then every option of that style is priced from them. Calls 
+	  and puts are homogeneous in the price and the strike, K payoff(S0 A / K) with a unit strike, so all
+	  the strikes of a style and type are one call of the vectorised grid kernel (see SDEBatch) with the
+	  spots S0 / K. The cost of the paths is paid once per underlying instead of once per option
+	- The paths are those of MonteCarlo with the same seed, NT and M, so each price is the one a 
+	  MonteCarlo run of that option alone gives at S0 without the control variate, up to rounding
+	- Blocks of paths run on all the threads, with one Accumulator per option merged in block order*/
+
+class Portfolio
+{
+private:
+	std::vector<OptionData> options;
+	long NT, M;
+	int SDE_type;	// 0 for Euler, 1 for exact simulation
+	unsigned nThreads;
+	uint32_t seed;
+	double time_elapsed;
+	std::vector<Accumulator> payoffs;	// Undiscounted payoffs of each option
+
+	// Runs paths first, ..., last (inclusive) and adds the sums of the payoffs of option i less shift[i], the 
+	// mean payoff of the first batch, to sum[i] and squared[i]
+	void portfolioBlock(long first, long last, double* sum, double* squared, double* shift) const;
+
+public:
+	// Constructor and destructors
+	Portfolio(const std::vector<OptionData>& options, long NT, long M, int SDE_type);
+	~Portfolio() {}
+
+	// Add an option to the book, it must have the dynamics of the ones already in it
+	void addOption(const OptionData& option);
+
+	// Set functions
+	void setNumberOfSteps(long NT);
+	void setNumberOfSimulations(long M);
+	void setNumberOfThreads(unsigned nThreads);
+	void setSeed(uint32_t seed);
+
+	// Get functions
+	long getNumberOfOptions();
+	double getTimeElapsed();
+	std::vector<OptionData> getOptions();
+	std::vector<Estimate> getEstimates();	// Discounted price, standard deviation and standard error of each option, in order
+
+	// Main function, prices every option in the book
+	void run();
+
+	// Print functions, one line per option with its type, style, strike, price and standard error
+	friend std::ostream& operator<< (std::ostream& os, const Portfolio& portfolio);
+};
+
+#endif // !PORTFOLIO_HPP
@@ -1,31 +1,167 @@
+
 #include "RNG.hpp"
-#include <random>
+#include "Parallel.hpp"
+#include "InstructionSet.hpp"
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Baseline copy of the batch normal kernel, built with the project's default instruction set
+#define KERNEL_SUFFIX Baseline
+#include "RNGKernels.inl"
+
+// Number of rows of the Wiener matrix handed to a thread at once
+static const long ROWS_PER_TASK = 256;
 
-std::vector<std::vector<double>> RNG::generateWienerProcesses(double dt)
+// Set and get functions
+void RNG::setSeed(uint32_t seed) { this->seed = seed; }
+void RNG::setStream(uint32_t stream) { this->stream = stream; }
+uint32_t RNG::getSeed() { return this->seed; }
+uint32_t RNG::getStream() { return this->stream; }
+
+static NormalsKernel normalsKernel()
+{
+	// Batch normal kernel for the instruction set of this CPU
+	switch (instructionSetInUse())
+	{
+	case InstructionSet::AVX512:
+		return philoxNormalsAVX512;
+	case InstructionSet::AVX2:
+		return philoxNormalsAVX2;
+	default:
+		return philoxNormalsBaseline;
+	}
+}
+
+void RNG::generateNormals(long path, long first, long n, double* Z, double scale) const
+{
+	// The counter is (pair of steps, 0, path) and the key is (seed, stream). Each Philox block gives
+	// two 52 bit uniforms in (0,1) which the Box-Muller transform turns into the normals of two steps,
+	// the cosine for the even step and the sine for the odd step.
+	// The pairs are made RNG_KERNEL_PAIRS at a time by the vectorised kernel
+	static const NormalsKernel kernel = normalsKernel();
+	uint64_t p = static_cast<uint64_t>(path);
+	double normals[2 * RNG_KERNEL_PAIRS];
+
+	long last = first + n;
+	long firstPair = first / 2;
+	long lastPair = (last + 1) / 2;	// One past the last pair needed
+	for (long chunk = firstPair; chunk < lastPair; chunk += RNG_KERNEL_PAIRS)
+	{
+		long pairs = std::min(RNG_KERNEL_PAIRS, lastPair - chunk);
+		kernel(this->seed, this->stream, static_cast<uint32_t>(chunk), static_cast<uint32_t>(p), 
+			static_cast<uint32_t>(p >> 32), pairs, scale, normals);
+
+		// Copy the steps that were asked for
+		long from = std::max(first, 2 * chunk);
+		long to = std::min(last, 2 * (chunk + pairs));
+		std::copy(normals + (from - 2 * chunk), normals + (to - 2 * chunk), Z + (from - first));
+	}
+}
+
+void RNG::generateWienerProcess(long path, double dt, double* dW) const
+{
+	// Generates the Wiener increments of one path
+	generateNormals(path, 0, this->NT + 1, dW, std::sqrt(dt));
+}
+
+Matrix RNG::generateWienerProcesses(double dt, unsigned nThreads)
 {
 	// Generates Wiener processes and stores as a matrix
-	// Normal (0,1) rng 
-	std::mt19937 rd;
-	std::default_random_engine generator(rd()); // rd() provides a random seed
-	std::normal_distribution<double> distribution(0, 1);
+	// Initialise matrix of Wiener paths, one row per path in a single block of memory
+	Matrix temp_paths(this->M + 1, this->NT + 1);
+
+	// Every row only depends on its own path number, so the rows can be split between the threads freely
+	long nTasks = (this->M + 1 + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	parallelFor(nTasks, nThreads, [&](long k)
+	{
+		long last = std::min(this->M + 1, (k + 1) * ROWS_PER_TASK);
+		for (long i = k * ROWS_PER_TASK; i < last; ++i)
+			generateWienerProcess(i, dt, temp_paths.row(i));
+	});
 
-	// Initialise matrix of Wiener paths
-	std::vector<std::vector<double>> temp_paths; 
+	// Set the member matrix dW as the paths generated
+	return temp_paths;
 
-	double sqrdt = std::sqrt(dt);
+}
 
-	for (long i = 0; i <= this->M; ++i)
+void RNG::matchMoments(Matrix& dW, long NT, double dt, int mode, unsigned nThreads)
+{
+	// Two sweeps over the rows, each row read in order so the loops over the steps vectorise: the sums
+	// and sums of squares of each step (or of W(T)) over the paths, then the shift and scale of each step.
+	// The sums of each task of rows are added in task order, so the result does not depend on the threads
+	long M = dW.getRows() - 1;
+	if (mode == 0 || M < 2 || NT <= 0)
+		return;
+	if (mode != 1 && mode != 2)
 	{
-		// Initialise temporary path
-		std::vector<double> temp_path;
-		for (long j = 0; j <= NT; ++j)
+		std::stringstream os;
+		os << "Invalid moment matching mode " << mode << "; use 0 (none), 1 (each time step) or 2 (W(T)).";
+		throw std::invalid_argument(os.str());
+	}
+	long columns = (mode == 1) ? NT : 1;
+	long nTasks = (M + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	std::vector<double> taskSums(nTasks * 2 * columns, 0.0);
+	parallelFor(nTasks, nThreads, [&](long k)
+	{
+		double* sums = taskSums.data() + k * 2 * columns;
+		double* squared = sums + columns;
+		long last = std::min(M, (k + 1) * ROWS_PER_TASK);
+		for (long i = 1 + k * ROWS_PER_TASK; i <= last; ++i)
 		{
-			// Add a random normally distributed Wiener process to the Wiener path
-			temp_path.push_back(sqrdt * distribution(generator));
+			const double* row = dW.row(i);
+			if (mode == 1)
+			{
+				for (long j = 0; j < NT; ++j)
+				{
+					sums[j] += row[j];
+					squared[j] += row[j] * row[j];
+				}
+			}
+			else
+			{
+				double W = 0.0;
+				for (long j = 0; j < NT; ++j)
+					W += row[j];
+				sums[0] += W;
+				squared[0] += W * W;
+			}
 		}
-		temp_paths.push_back(temp_path);
+	});
+
+	// Shift and scale of each column, for W(T) the variance to match is NT dt
+	double MC = static_cast<double>(M);
+	double target = (mode == 1) ? dt : NT * dt;
+	std::vector<double> shift(NT), scale(NT);
+	for (long j = 0; j < columns; ++j)
+	{
+		double sum = 0.0, squaredSum = 0.0;
+		for (long k = 0; k < nTasks; ++k)
+		{
+			sum += taskSums[k * 2 * columns + j];
+			squaredSum += taskSums[k * 2 * columns + columns + j];
+		}
+		double mean = sum / MC;
+		double variance = squaredSum / MC - mean * mean;
+		shift[j] = mean;
+		scale[j] = (variance > 0.0) ? std::sqrt(target / variance) : 1.0;
+	}
+	if (mode == 2)
+	{
+		// W(T) - mean is made by taking mean / NT off every step
+		std::fill(shift.begin(), shift.end(), shift[0] / static_cast<double>(NT));
+		std::fill(scale.begin(), scale.end(), scale[0]);
 	}
-	// Set the member matrix dW as the paths generated
-	return temp_paths;
 
-}
\ No newline at end of file
+	parallelFor(nTasks, nThreads, [&](long k)
+	{
+		long last = std::min(M, (k + 1) * ROWS_PER_TASK);
+		for (long i = 1 + k * ROWS_PER_TASK; i <= last; ++i)
+		{
+			double* row = dW.row(i);
+			for (long j = 0; j < NT; ++j)
+				row[j] = (row[j] - shift[j]) * scale[j];
+		}
+	});
+}
@@ -3,22 +3,52 @@
 
 // Built-in header files
 #include <vector>
+#include <cstdint>
+
+// Custom header files
+#include "Matrix.hpp"
 
 /* ABOUT
 	- Random number generator
 	- Used to create Wiener process values in the Monte Carlo simulations
+	- Counter-based (Philox4x32-10, Salmon et al. 2011): every normal is a pure function of 
+	  (seed, stream, path, step), so any path can be generated on its own, on any thread or 
+	  process, and skipping ahead to a later path or step costs nothing
+	- Different stream numbers give independent sequences for the same seed
+	- The normals are made in blocks by a vectorised Philox + Box-Muller kernel, see RNGKernels.hpp
 */
 class RNG
 {
 private:
 	long NT, M;
+	uint32_t seed, stream;
 
 public: 
-	RNG(long NT, long M) : NT(NT), M(M) {}
+	RNG(long NT, long M, uint32_t seed = 0, uint32_t stream = 0) : NT(NT), M(M), seed(seed), stream(stream) {}
 	~RNG() {}
-	std::vector<std::vector<double>> generateWienerProcesses(double dt);
+
+	// Set and get functions
+	void setSeed(uint32_t seed);
+	void setStream(uint32_t stream);
+	uint32_t getSeed();
+	uint32_t getStream();
+
+	// Normals number first, ..., first + n - 1 of a path, multiplied by scale
+	void generateNormals(long path, long first, long n, double* Z, double scale = 1.0) const;
+
+	// Wiener increments dW[0], ..., dW[NT] of a single path
+	void generateWienerProcess(long path, double dt, double* dW) const;
+
+	// Wiener increments of paths 0, ..., M as a matrix, the same for any number of threads
+	Matrix generateWienerProcesses(double dt, unsigned nThreads = 1);
+
+	// Moment matching of the Wiener increments of paths 1, ..., M (rows 1, ..., M of dW, steps 0, ..., NT - 1):
+	// mode 1 shifts and scales each time step so its sample mean is 0 and its sample variance dt, mode 2
+	// does the same to W(T) and spreads the shift evenly over the steps. Removes the sampling error of the
+	// first two moments, at the cost of making the paths slightly dependent (the standard error is then an
+	// estimate). With the antithetic twins the mean is already 0, so it is the variance that counts
+	static void matchMoments(Matrix& dW, long NT, double dt, int mode, unsigned nThreads = 1);
 
 };
 
 #endif // !RNG_HPP
-
@@ -0,0 +1,28 @@
+#ifndef RNG_KERNELS_HPP
+#define RNG_KERNELS_HPP
+
+// Built-in header files
+#include <cstdint>
+
+/* ABOUT
+	- Declarations of the batch normal kernels used by RNG, one copy per instruction set
+	- Each call turns up to RNG_KERNEL_PAIRS consecutive Philox4x32-10 counters into pairs of
+	  normals: counters (firstCounter + k, 0, c2, c3) under key (key0, key1), two 52 bit uniforms 
+	  per counter and Box-Muller, normals[2k] = cosine and normals[2k + 1] = sine, times scale*/
+
+// Number of counters handled by one kernel call
+const long RNG_KERNEL_PAIRS = 64;
+
+// Signature of the batch normal kernels
+typedef void (*NormalsKernel)(uint32_t key0, uint32_t key1, uint32_t firstCounter, uint32_t c2, uint32_t c3,
+	long pairs, double scale, double* normals);
+
+// Kernels for each instruction set
+void philoxNormalsBaseline(uint32_t key0, uint32_t key1, uint32_t firstCounter, uint32_t c2, uint32_t c3,
+	long pairs, double scale, double* normals);
+void philoxNormalsAVX2(uint32_t key0, uint32_t key1, uint32_t firstCounter, uint32_t c2, uint32_t c3,
+	long pairs, double scale, double* normals);
+void philoxNormalsAVX512(uint32_t key0, uint32_t key1, uint32_t firstCounter, uint32_t c2, uint32_t c3,
+	long pairs, double scale, double* normals);
+
+#endif // !RNG_KERNELS_HPP
@@ -0,0 +1,72 @@
+// RNGKernels.inl
+//
+// Bodies of the batch normal kernels, included by RNG.cpp, Kernels_avx2.cpp and Kernels_avx512.cpp
+// with KERNEL_SUFFIX set to the instruction set, so each file defines its own copy.
+// Philox rounds, uniforms and Box-Muller are each a simple loop over the counters of the chunk,
+// which the compiler turns into vector instructions of the instruction set the file is compiled for.
+
+#ifndef KERNEL_SUFFIX
+#error "Define KERNEL_SUFFIX before including RNGKernels.inl"
+#endif
+
+#include <cmath>
+#include "RNGKernels.hpp"
+#include "BatchMath.hpp"
+
+#define RNG_KERNEL_CONCAT(name, suffix) name##suffix
+#define RNG_KERNEL_NAME(name, suffix) RNG_KERNEL_CONCAT(name, suffix)
+
+void RNG_KERNEL_NAME(philoxNormals, KERNEL_SUFFIX)(uint32_t key0, uint32_t key1, uint32_t firstCounter, uint32_t c2, uint32_t c3,
+	long pairs, double scale, double* normals)
+{
+	// Philox4x32 multipliers and Weyl sequence constants for the key schedule
+	const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+	const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+	const uint64_t oneBits = 0x3FF0000000000000ULL;
+	const double oneMinusHalfUlp = 1.0 - 1.0 / 9007199254740992.0;
+	const double twoPi = 6.28318530717958647693;
+
+	uint32_t r0[RNG_KERNEL_PAIRS], r1[RNG_KERNEL_PAIRS], r2[RNG_KERNEL_PAIRS], r3[RNG_KERNEL_PAIRS];
+	for (long k = 0; k < pairs; ++k)
+	{
+		r0[k] = firstCounter + static_cast<uint32_t>(k);
+		r1[k] = 0;
+		r2[k] = c2;
+		r3[k] = c3;
+	}
+
+	// Ten Philox rounds, bumping the key between the rounds
+	for (int round = 0; round < 10; ++round)
+	{
+		for (long k = 0; k < pairs; ++k)
+		{
+			uint64_t p0 = static_cast<uint64_t>(M0) * r0[k];
+			uint64_t p1 = static_cast<uint64_t>(M1) * r2[k];
+			uint32_t old1 = r1[k], old3 = r3[k];
+			r0[k] = static_cast<uint32_t>(p1 >> 32) ^ old1 ^ key0;
+			r1[k] = static_cast<uint32_t>(p1);
+			r2[k] = static_cast<uint32_t>(p0 >> 32) ^ old3 ^ key1;
+			r3[k] = static_cast<uint32_t>(p0);
+		}
+		key0 += W0;
+		key1 += W1;
+	}
+
+	// Uniforms in (0,1) from the top 52 bits of each 64 bit half: the bits are put in the mantissa
+	// of a number in [1,2), then 1 - 2^-53 is taken away. Box-Muller, already multiplied by the scale
+	for (long k = 0; k < pairs; ++k)
+	{
+		uint64_t x1 = (static_cast<uint64_t>(r0[k]) << 32) | r1[k];
+		uint64_t x2 = (static_cast<uint64_t>(r2[k]) << 32) | r3[k];
+		double u1 = batchBitsToDouble(static_cast<int64_t>(oneBits | (x1 >> 12))) - oneMinusHalfUlp;
+		double u2 = batchBitsToDouble(static_cast<int64_t>(oneBits | (x2 >> 12))) - oneMinusHalfUlp;
+		double radius = scale * std::sqrt(-2.0 * batchLog(u1));
+		double sine, cosine;
+		batchSinCos(twoPi * u2, sine, cosine);
+		normals[2 * k] = radius * cosine;
+		normals[2 * k + 1] = radius * sine;
+	}
+}
+
+#undef RNG_KERNEL_NAME
+#undef RNG_KERNEL_CONCAT
@@ -19,58 +19,69 @@ double SDE::diffusion(double t, double S)
 
 std::tuple< std::vector<double>, std::vector<double>> SDE::generatePaths(double S, const std::vector<double> &dW)
 {
-	// Define and initialise variables 
-	double dt = data->T / static_cast<double>(this->NT);
-	double sqrdt = std::sqrt(dt);
-	double t = 0.0;
-
 	// Calculate a path at each iteration
 	std::vector<double> path_plus;
 	std::vector<double> path_minus;
 
-	// Tuples to store plus and minus paths for AVR // TODO: COMMENT
-	std::tuple <double, double> VOld;
-	std::tuple <double, double> VNew;
+	// Fill the paths and return both the path and the negated path as a tuple of vectors
+	generatePaths(S, dW, path_plus, path_minus);
+	std::tuple<std::vector<double>, std::vector<double>> returnTuple{ path_plus, path_minus };
+	return returnTuple;
+}
+
+void SDE::generatePaths(double S, const std::vector<double>& dW, std::vector<double>& path_plus,
+	std::vector<double>& path_minus)
+{
+	// Writes the path and its antithetic twin into the buffers provided, so a caller 
+	// can reuse the same two buffers for every simulation instead of allocating new ones
+	path_plus.resize(NT + 1);
+	path_minus.resize(NT + 1);
+	generatePaths(S, dW.data(), path_plus.data(), path_minus.data());
+}
 
-	// Initialise tuples
-	VOld = std::make_tuple(S, S);
-	VNew = std::make_tuple(0.0, 0.0);
+void SDE::generatePaths(double S, const double* dW, double* path_plus, double* path_minus)
+{
+	// Writes the path and its antithetic twin into memory provided by the caller, 
+	// e.g. two rows of a path matrix
+	double dt = data->T / static_cast<double>(this->NT);
+	double t = 0.0;
 
-	// Loop through the number of time steps
-	for (long index = 0; index < NT; ++index)
+	// Plus and minus values for AVR (antithetic variance reduction)
+	double VOld_plus = S, VOld_minus = S;
+
+	// Loop through the number of time steps, the scheme is picked once outside the loop
+	if (SDE_type == 0)
 	{
-		t += dt;
 		// Euler
-		if (SDE_type == 0)
+		for (long index = 0; index < NT; ++index)
 		{
-			std::get<0>(VNew) = std::get<0>(VOld) + drift(t, std::get<0>(VOld)) * dt 
-				+ diffusion(t, std::get<0>(VOld)) * dW[index];
-			std::get<1>(VNew) = std::get<1>(VOld) + drift(t, std::get<1>(VOld)) * dt
-				- diffusion(t, std::get<1>(VOld)) * dW[index];
+			t += dt;
+
+			// Store the current values
+			path_plus[index] = VOld_plus;
+			path_minus[index] = VOld_minus;
+
+			VOld_plus = VOld_plus + drift(t, VOld_plus) * dt + diffusion(t, VOld_plus) * dW[index];
+			VOld_minus = VOld_minus + drift(t, VOld_minus) * dt - diffusion(t, VOld_minus) * dW[index];
 		}
+	}
+	else if (SDE_type == 1)
+	{
 		// Exact
-		else if (SDE_type == 1)
+		for (long index = 0; index < NT; ++index)
 		{
-			std::get<0>(VNew) = std::get<0>(VOld) * std::exp(drift(t, 1.0) * dt
-				+ diffusion(t, 1.0) * dW[index]);
-			std::get<1>(VNew) = std::get<1>(VOld) * std::exp(drift(t, 1.0) * dt
-				- diffusion(t, 1.0) * dW[index]);
-		}
+			t += dt;
 
-		// Add to vector
-		path_plus.push_back(std::get<0>(VOld));
-		path_minus.push_back(std::get<1>(VOld));
+			// Store the current values
+			path_plus[index] = VOld_plus;
+			path_minus[index] = VOld_minus;
 
-		// Update values
-		std::get<0>(VOld) = std::get<0>(VNew);
-		std::get<1>(VOld) = std::get<1>(VNew);
+			VOld_plus = VOld_plus * std::exp(drift(t, 1.0) * dt + diffusion(t, 1.0) * dW[index]);
+			VOld_minus = VOld_minus * std::exp(drift(t, 1.0) * dt - diffusion(t, 1.0) * dW[index]);
+		}
 	}
 
-	// Return both the path and the negated path as a tuple of vectors
-	path_plus.push_back(std::get<0>(VOld));
-	path_minus.push_back(std::get<1>(VOld));
-
-	// Make tuple and return 
-	std::tuple<std::vector<double>, std::vector<double>> returnTuple{ path_plus, path_minus };
-	return returnTuple;
-}
\ No newline at end of file
+	// Terminal values
+	path_plus[NT] = VOld_plus;
+	path_minus[NT] = VOld_minus;
+}
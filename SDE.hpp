@@ -5,6 +5,8 @@
 #include <cmath>
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <tuple>
 
 // Custom header files
 #include "OptionData.hpp"
@@ -31,6 +33,84 @@ public:
 	double diffusion(double t, double S);
 
 	std::tuple<std::vector<double>, std::vector<double>> generatePaths(double S, const std::vector<double> &dW);
+	void generatePaths(double S, const std::vector<double>& dW, std::vector<double>& path_plus, 
+		std::vector<double>& path_minus);
+	void generatePaths(double S, const double* dW, double* path_plus, double* path_minus);	// NT + 1 prices each
+
+	// Averages of the path from S and its twin that go into the payoff (see PayoffAccumulator), for standard
+	// normal draws Z (dW / sqrt(dt)). The option data are arguments of any number type, e.g. Number to 
+	// take the sensitivities to all of them in one backward sweep (see AAD.hpp)
+	template <typename Real>
+	void generateAverages(const Real& S, const Real& r, const Real& D, const Real& sigma, const Real& T,
+		const double* Z, Real& average_plus, Real& average_minus) const;
 };
 
+template <typename Real>
+void SDE::generateAverages(const Real& S, const Real& r, const Real& D, const Real& sigma, const Real& T,
+	const double* Z, Real& average_plus, Real& average_minus) const
+{
+	// Same schemes as generatePaths, with each step written as a factor of the price. The increments
+	// are sqrt(dt) Z, so they move with T. Found by argument dependent lookup for Number
+	using std::exp;
+	using std::log;
+	using std::sqrt;
+	Real dt = T / static_cast<double>(this->NT);
+	Real volatility = sigma * sqrt(dt);
+	Real drift = (this->SDE_type == 0) ? (r - D) * dt : (r - D - 0.5 * sigma * sigma) * dt;
+	int style = this->data->style;
+
+	// Plus and minus values for AVR (antithetic variance reduction), folded into the averages as they are made
+	Real VOld_plus = S, VOld_minus = S;
+	Real sum_plus = (style == 2) ? log(S) : S;
+	Real sum_minus = sum_plus;
+
+	// Each step multiplies the price by a factor, 1 + drift + diffusion (Euler) or exp(drift + diffusion) (exact)
+	Real growth = 1.0 + drift;
+	for (long index = 0; index < NT; ++index)
+	{
+		Real diffusion = volatility * Z[index];
+		if (this->SDE_type == 0)
+		{
+			// Euler
+			VOld_plus = VOld_plus * (growth + diffusion);
+			VOld_minus = VOld_minus * (growth - diffusion);
+		}
+		else
+		{
+			// Exact
+			VOld_plus = VOld_plus * exp(drift + diffusion);
+			VOld_minus = VOld_minus * exp(drift - diffusion);
+		}
+
+		if (style == 1)
+		{
+			sum_plus = sum_plus + VOld_plus;
+			sum_minus = sum_minus + VOld_minus;
+		}
+		else if (style == 2)
+		{
+			sum_plus = sum_plus + log(VOld_plus);
+			sum_minus = sum_minus + log(VOld_minus);
+		}
+	}
+
+	// Last price, arithmetic or geometric average of the NT + 1 prices
+	double n = static_cast<double>(this->NT + 1);
+	if (style == 1)
+	{
+		average_plus = sum_plus / n;
+		average_minus = sum_minus / n;
+	}
+	else if (style == 2)
+	{
+		average_plus = exp(sum_plus / n);
+		average_minus = exp(sum_minus / n);
+	}
+	else
+	{
+		average_plus = VOld_plus;
+		average_minus = VOld_minus;
+	}
+}
+
 #endif // !SDE_HPP
@@ -0,0 +1,109 @@
+#include "SDEBatch.hpp"
+#include "InstructionSet.hpp"
+
+// Baseline copies of the batch kernels, built with the project's default instruction set
+#define KERNEL_SUFFIX Baseline
+#include "SDEBatchKernels.inl"
+
+SDEBatch::SDEBatch(const OptionData& optionData, int SDE_type, long NT, bool control, double shift)
+{
+	// Define the parameters of the scheme
+	this->params.NT = NT;
+	this->params.dt = optionData.T / static_cast<double>(NT);
+	this->params.sigma = optionData.sigma;
+	this->params.K = optionData.K;
+	if (SDE_type == 0)	// Euler
+		this->params.mu = optionData.r - optionData.D;
+	else				// Exact
+		this->params.mu = optionData.r - optionData.D - 0.5 * optionData.sigma * optionData.sigma;
+	this->params.logDrift = optionData.r - optionData.D - 0.5 * optionData.sigma * optionData.sigma;
+
+	// A shift of the Brownian motion is a shift of the drift of both schemes by sigma * shift
+	this->params.shift = shift;
+	this->params.mu += optionData.sigma * shift;
+	this->params.logDrift += optionData.sigma * shift;
+
+	// Choose the kernels for the scheme, the option and the instruction set, once, so the
+	// kernels themselves have no branches on any of them
+	switch (instructionSetInUse())
+	{
+	case InstructionSet::AVX512:
+		this->kernel = (SDE_type == 0) ? eulerBatchAVX512 : exactBatchAVX512;
+		this->averageKernel = averageKernelAVX512(SDE_type, optionData.style, control);
+		this->payoffKernel = payoffKernelAVX512(SDE_type, optionData.style, optionData.type, shift != 0.0);
+		this->gridKernel = gridKernelAVX512(optionData.type);
+		this->greeksKernel = greeksKernelAVX512(SDE_type, optionData.style, optionData.type);
+		this->controlKernel = controlKernelAVX512(optionData.type);
+		break;
+	case InstructionSet::AVX2:
+		this->kernel = (SDE_type == 0) ? eulerBatchAVX2 : exactBatchAVX2;
+		this->averageKernel = averageKernelAVX2(SDE_type, optionData.style, control);
+		this->payoffKernel = payoffKernelAVX2(SDE_type, optionData.style, optionData.type, shift != 0.0);
+		this->gridKernel = gridKernelAVX2(optionData.type);
+		this->greeksKernel = greeksKernelAVX2(SDE_type, optionData.style, optionData.type);
+		this->controlKernel = controlKernelAVX2(optionData.type);
+		break;
+	default:
+		this->kernel = (SDE_type == 0) ? eulerBatchBaseline : exactBatchBaseline;
+		this->averageKernel = averageKernelBaseline(SDE_type, optionData.style, control);
+		this->payoffKernel = payoffKernelBaseline(SDE_type, optionData.style, optionData.type, shift != 0.0);
+		this->gridKernel = gridKernelBaseline(optionData.type);
+		this->greeksKernel = greeksKernelBaseline(SDE_type, optionData.style, optionData.type);
+		this->controlKernel = controlKernelBaseline(optionData.type);
+		break;
+	}
+}
+
+void SDEBatch::generatePaths(double S, const double* dW, double* plus, double* minus) const
+{
+	// Run the chosen kernel
+	this->kernel(this->params, S, dW, plus, minus);
+}
+
+void SDEBatch::generateAverages(double S, const double* dW, SDEBatchPaths& paths) const
+{
+	// Run the chosen average kernel
+	this->averageKernel(this->params, S, dW, paths);
+}
+
+void SDEBatch::generatePayoffs(double S, const double* dW, double* payoffs) const
+{
+	// Run the chosen payoff kernel
+	this->payoffKernel(this->params, S, dW, payoffs);
+}
+
+void SDEBatch::accumulateGrid(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths,
+	const double* shift, double* sum, double* squared) const
+{
+	// Run the chosen grid kernel
+	this->gridKernel(this->params, spots, nSpots, lanes, paths, shift, sum, squared);
+}
+
+void SDEBatch::accumulateGreeks(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths, const double* deltaShift,
+	const double* gammaShift, double* deltaSum, double* deltaSquared, double* gammaSum, double* gammaSquared) const
+{
+	// Run the chosen Greek kernel
+	this->greeksKernel(this->params, spots, nSpots, lanes, paths, deltaShift, gammaShift, deltaSum, deltaSquared, gammaSum, gammaSquared);
+}
+
+void SDEBatch::accumulateControl(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths, const double* controlShift,
+	const double* payoffShift, double* controlSum, double* controlSquared, double* crossSum) const
+{
+	// Run the chosen control kernel
+	this->controlKernel(this->params, spots, nSpots, lanes, paths, controlShift, payoffShift, controlSum, controlSquared, crossSum);
+}
+
+void SDEBatch::loadBatchIncrements(const RNG& randGen, long batch, long lanes, long NT, double dt, double* dW, double* buffer)
+{
+	loadLanes([&](long path)
+	{
+		randGen.generateWienerProcess(path, dt, buffer);
+		return static_cast<const double*>(buffer);
+	}, batch, lanes, NT, dW);
+}
+
+std::string SDEBatch::instructionSet()
+{
+	// Name of the instruction set used by the kernels
+	return instructionSetName();
+}
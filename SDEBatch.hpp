@@ -0,0 +1,95 @@
+#ifndef SDE_BATCH_HPP
+#define SDE_BATCH_HPP
+
+// Built-in header files
+#include <string>
+
+// Custom header files
+#include "OptionData.hpp"
+#include "RNG.hpp"
+#include "SDEBatchKernels.hpp"
+
+/* ABOUT
+	- Batched version of the SDE schemes used by the streaming Monte Carlo engine
+	- Advances LANES paths and their antithetic twins in lockstep over structure-of-arrays
+	  buffers, element [step * LANES + lane], so the update of every step is one vector
+	  operation over the lanes instead of one scalar update per path
+	- The kernels are compiled once per instruction set (SDEBatch.cpp for the baseline,
+	  Kernels_avx2.cpp and Kernels_avx512.cpp with /arch:AVX2 and /arch:AVX512) and the
+	  best one the CPU supports is picked at run time, see InstructionSet.hpp
+	- The average and payoff kernels are templates over the scheme, the averaging style and
+	  the payoff direction, built for every combination; the SDE type and the option's style 
+	  and type pick one when the SDEBatch is made, so the kernels have no branches on them*/
+
+class SDEBatch
+{
+private:
+	SDEBatchParameters params;
+	SDEBatchKernel kernel;
+	SDEAverageKernel averageKernel;
+	SDEPayoffKernel payoffKernel;
+	SDEGridKernel gridKernel;
+	SDEGreeksKernel greeksKernel;
+	SDEControlKernel controlKernel;
+
+public:
+	// Number of paths advanced together
+	static const long LANES = SDE_BATCH_LANES;
+
+	// Paths in each block of work the engines hand to a thread, fixed so that the order in which the
+	// block results are merged does not depend on the number of threads
+	static const long PATHS_PER_BLOCK = 1024;
+
+	// Puts the increments of paths batch, ..., batch + lanes - 1 in the lanes of dW, element [step * LANES + lane],
+	// step = 0, ..., NT - 1, unused lanes get zeros. increments(path) gives a pointer to the NT increments of a path
+	template <typename Increments>
+	static void loadLanes(Increments increments, long batch, long lanes, long NT, double* dW)
+	{
+		for (long l = 0; l < LANES; ++l)
+		{
+			const double* row = (l < lanes) ? increments(batch + l) : nullptr;
+			for (long j = 0; j < NT; ++j)
+				dW[j * LANES + l] = (row != nullptr) ? row[j] : 0.0;
+		}
+	}
+
+	// loadLanes with the increments of randGen (NT steps of dt), using buffer (NT + 1 values) for each path
+	static void loadBatchIncrements(const RNG& randGen, long batch, long lanes, long NT, double dt, double* dW, double* buffer);
+
+	// With control, generateAverages also makes the geometric averages of the exact paths on the same
+	// increments (arithmetic Asian options only), for accumulateControl. A nonzero shift adds shift * dt
+	// to every Wiener increment (importance sampling), and generatePayoffs weights each payoff by the
+	// likelihood ratio of its path, so the mean payoff is unchanged
+	SDEBatch(const OptionData& optionData, int SDE_type, long NT, bool control = false, double shift = 0.0);
+
+	// Generates LANES paths starting at S and their antithetic twins from dW[step * LANES + lane], 
+	// step = 0, ..., NT - 1. The paths are written to plus and minus, step = 0, ..., NT
+	void generatePaths(double S, const double* dW, double* plus, double* minus) const;
+
+	// As generatePaths, but only the averages of the paths that go into the payoff (and the prices
+	// after the first step) are written, the paths are folded into them as they are made and never stored
+	void generateAverages(double S, const double* dW, SDEBatchPaths& paths) const;
+
+	// As generateAverages, but writes the mean undiscounted payoff of each path and its twin
+	void generatePayoffs(double S, const double* dW, double* payoffs) const;
+
+	// Scales the averages of LANES paths started at 1 (from generateAverages, the first lanes of them in use)
+	// to every spot and adds the mean payoff of each pair less shift[k] to sum[k] and its square to squared[k]
+	void accumulateGrid(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths, 
+		const double* shift, double* sum, double* squared) const;
+
+	// As accumulateGrid for the pathwise delta and the conditional density gamma estimators, undiscounted
+	void accumulateGreeks(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths, const double* deltaShift,
+		const double* gammaShift, double* deltaSum, double* deltaSquared, double* gammaSum, double* gammaSquared) const;
+
+	// As accumulateGrid for the payoffs of the geometric controls (SDEBatch made with control) less controlShift[k], 
+	// adds their sums and squares to controlSum[k] and controlSquared[k] and their products with the payoffs 
+	// less payoffShift[k] to crossSum[k]
+	void accumulateControl(const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths, const double* controlShift,
+		const double* payoffShift, double* controlSum, double* controlSquared, double* crossSum) const;
+
+	// Instruction set chosen for this CPU
+	static std::string instructionSet();
+};
+
+#endif // !SDE_BATCH_HPP
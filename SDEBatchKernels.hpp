@@ -0,0 +1,91 @@
+#ifndef SDE_BATCH_KERNELS_HPP
+#define SDE_BATCH_KERNELS_HPP
+
+/* ABOUT
+	- Declarations of the batch kernels used by SDEBatch, one copy per instruction set
+	- Kept free of other headers: the AVX2 and AVX-512 files include only this and BatchMath.hpp,
+	  so no inline library code is compiled with the wider instruction sets and then shared
+	  with the rest of the program by the linker*/
+
+// Number of paths advanced together, 8 doubles fill one AVX-512 register
+const long SDE_BATCH_LANES = 8;
+
+// Data used by the batch kernels
+struct SDEBatchParameters
+{
+	long NT;		// Number of time steps
+	double dt;		// Time step
+	double mu;		// Drift, (r - D) for Euler and (r - D - sigma^2/2) for the exact scheme
+	double sigma;	// Volatility
+	double K;		// Strike, used by the payoff kernels
+	double logDrift;	// Drift of the log price, (r - D - sigma^2/2), used by the geometric control
+	double shift;	// Drift of the Brownian motion under importance sampling (included in mu and logDrift), 0 if not used
+};
+
+// Signature of the batch kernels: S is the initial price, dW the increments and the
+// paths are written to plus and minus, all in structure-of-arrays layout
+typedef void (*SDEBatchKernel)(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+
+// Averages of LANES paths and their twins (last price, arithmetic or geometric average, see 
+// PayoffAccumulator), and their prices after the first step, used by the Greeks
+struct SDEBatchPaths
+{
+	double averagePlus[SDE_BATCH_LANES], averageMinus[SDE_BATCH_LANES];
+	double firstPlus[SDE_BATCH_LANES], firstMinus[SDE_BATCH_LANES];
+	double controlPlus[SDE_BATCH_LANES], controlMinus[SDE_BATCH_LANES];	// Geometric averages of the exact paths, control variate only
+};
+
+// Signature of the average kernels: as the batch kernels, but each path is folded into its payoff
+// average as it is made and only the averages and the prices after the first step are written
+typedef void (*SDEAverageKernel)(const SDEBatchParameters& p, double S, const double* dW, SDEBatchPaths& paths);
+
+// Signature of the payoff kernels: as the average kernels, then the mean of the undiscounted
+// payoffs of each path and its antithetic twin is written to payoffs, one per lane
+typedef void (*SDEPayoffKernel)(const SDEBatchParameters& p, double S, const double* dW, double* payoffs);
+
+// Signature of the grid kernels: the averages of LANES paths and their twins started at 1 (the first
+// lanes of them in use) are scaled to every spot, spots[k] * average, and the mean payoff of each
+// pair less shift[k] is added to sum[k] and its square to squared[k], k = 0, ..., nSpots - 1.
+// A shift close to the mean keeps the sums of squares from cancelling (see Accumulator::fromSums)
+typedef void (*SDEGridKernel)(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes, 
+	const SDEBatchPaths& paths, const double* shift, double* sum, double* squared);
+
+// Signature of the control kernels: as the grid kernels, for the mean payoff of the geometric controls of
+// each pair less controlShift[k], added to controlSum[k] and its square to controlSquared[k], and its 
+// product with the mean payoff of the pair less payoffShift[k] to crossSum[k]
+typedef void (*SDEControlKernel)(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes,
+	const SDEBatchPaths& paths, const double* controlShift, const double* payoffShift, double* controlSum, 
+	double* controlSquared, double* crossSum);
+
+// Signature of the Greek kernels: as the grid kernels, for the mean delta and gamma estimators of each
+// pair less deltaShift[k] and gammaShift[k], undiscounted (see greeksBatch in SDEBatchKernels.inl)
+typedef void (*SDEGreeksKernel)(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths,
+	const double* deltaShift, const double* gammaShift, double* deltaSum, double* deltaSquared, double* gammaSum, double* gammaSquared);
+
+// Kernels for each instruction set
+void eulerBatchBaseline(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+void exactBatchBaseline(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+void eulerBatchAVX2(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+void exactBatchAVX2(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+void eulerBatchAVX512(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+void exactBatchAVX512(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus);
+
+// The average and payoff kernels are compiled for every combination of scheme (SDE_type),
+// style and payoff direction (type 'C' or 'P'), these pick the one for the given combination
+SDEAverageKernel averageKernelBaseline(int SDE_type, int style, bool control);
+SDEAverageKernel averageKernelAVX2(int SDE_type, int style, bool control);
+SDEAverageKernel averageKernelAVX512(int SDE_type, int style, bool control);
+SDEPayoffKernel payoffKernelBaseline(int SDE_type, int style, char type, bool weighted);
+SDEPayoffKernel payoffKernelAVX2(int SDE_type, int style, char type, bool weighted);
+SDEPayoffKernel payoffKernelAVX512(int SDE_type, int style, char type, bool weighted);
+SDEGridKernel gridKernelBaseline(char type);
+SDEGridKernel gridKernelAVX2(char type);
+SDEGridKernel gridKernelAVX512(char type);
+SDEControlKernel controlKernelBaseline(char type);
+SDEControlKernel controlKernelAVX2(char type);
+SDEControlKernel controlKernelAVX512(char type);
+SDEGreeksKernel greeksKernelBaseline(int SDE_type, int style, char type);
+SDEGreeksKernel greeksKernelAVX2(int SDE_type, int style, char type);
+SDEGreeksKernel greeksKernelAVX512(int SDE_type, int style, char type);
+
+#endif // !SDE_BATCH_KERNELS_HPP
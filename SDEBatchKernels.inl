@@ -0,0 +1,491 @@
+// SDEBatchKernels.inl
+//
+// Bodies of the batch kernels, included by SDEBatch.cpp, Kernels_avx2.cpp and Kernels_avx512.cpp
+// with KERNEL_SUFFIX set to the instruction set, so each file defines its own copies.
+// The lane loops have a fixed trip count and no branches, which the compiler turns into
+// vector instructions of the instruction set the file is compiled for.
+
+#ifndef KERNEL_SUFFIX
+#error "Define KERNEL_SUFFIX before including SDEBatchKernels.inl"
+#endif
+
+#include "SDEBatchKernels.hpp"
+#include "BatchMath.hpp"
+#include <cmath>
+
+#define SDE_BATCH_CONCAT(name, suffix) name##suffix
+#define SDE_BATCH_NAME(name, suffix) SDE_BATCH_CONCAT(name, suffix)
+
+void SDE_BATCH_NAME(eulerBatch, KERNEL_SUFFIX)(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus)
+{
+	// Euler: S(t + dt) = S(t) + mu * S(t) * dt +/- sigma * S(t) * dW
+	const long L = SDE_BATCH_LANES;
+	const double mudt = p.mu * p.dt;
+	for (long l = 0; l < L; ++l)
+	{
+		plus[l] = S;
+		minus[l] = S;
+	}
+	for (long j = 0; j < p.NT; ++j)
+	{
+		const double* w = dW + j * L;
+		const double* oldPlus = plus + j * L;
+		const double* oldMinus = minus + j * L;
+		double* newPlus = plus + (j + 1) * L;
+		double* newMinus = minus + (j + 1) * L;
+		for (long l = 0; l < L; ++l)
+		{
+			newPlus[l] = oldPlus[l] + mudt * oldPlus[l] + p.sigma * oldPlus[l] * w[l];
+			newMinus[l] = oldMinus[l] + mudt * oldMinus[l] - p.sigma * oldMinus[l] * w[l];
+		}
+	}
+}
+
+void SDE_BATCH_NAME(exactBatch, KERNEL_SUFFIX)(const SDEBatchParameters& p, double S, const double* dW, double* plus, double* minus)
+{
+	// Exact: S(t + dt) = S(t) * exp(mu * dt +/- sigma * dW)
+	// The twin's factor is exp(2 * mu * dt) / exp(mu * dt + sigma * dW), one exponential per pair
+	const long L = SDE_BATCH_LANES;
+	const double mudt = p.mu * p.dt;
+	const double twinFactor = batchExp(2.0 * mudt);
+	for (long l = 0; l < L; ++l)
+	{
+		plus[l] = S;
+		minus[l] = S;
+	}
+	for (long j = 0; j < p.NT; ++j)
+	{
+		const double* w = dW + j * L;
+		const double* oldPlus = plus + j * L;
+		const double* oldMinus = minus + j * L;
+		double* newPlus = plus + (j + 1) * L;
+		double* newMinus = minus + (j + 1) * L;
+		for (long l = 0; l < L; ++l)
+		{
+			double factor = batchExp(mudt + p.sigma * w[l]);
+			newPlus[l] = oldPlus[l] * factor;
+			newMinus[l] = oldMinus[l] * (twinFactor / factor);
+		}
+	}
+}
+
+// Policies of the compile-time specialised kernels. They live in an unnamed namespace
+// so the copies built for different instruction sets are never merged by the linker
+namespace
+{
+	// Schemes: one step of a path and its antithetic twin
+	// firstDensity: density of the first step's factor at f = c g(a) times df/da = c g'(a), for the
+	// gamma. lane comes from laneFactor(c), once per path, and logG = log(g) when g > 0
+	struct EulerScheme
+	{
+		double mudt, sigma, firstInverse;
+		explicit EulerScheme(const SDEBatchParameters& p) : mudt(p.mu * p.dt), sigma(p.sigma), firstInverse(1.0 / (p.sigma * std::sqrt(p.dt))) {}
+		void step(double& plus, double& minus, double w) const
+		{
+			plus = plus + mudt * plus + sigma * plus * w;
+			minus = minus + mudt * minus - sigma * minus * w;
+		}
+
+		// The factor 1 + mu dt + sigma dW is normal
+		static double laneFactor(double c) { return c; }
+		double firstDensity(double lane, double g, double /*logG*/, double gSlope) const
+		{
+			const double z = (lane * g - 1.0 - mudt) * firstInverse;
+			return 0.39894228040143267794 * firstInverse * batchExp(-0.5 * z * z) * lane * gSlope;
+		}
+	};
+
+	struct ExactScheme
+	{
+		double mudt, sigma, twinFactor, firstInverse;
+		explicit ExactScheme(const SDEBatchParameters& p) : mudt(p.mu * p.dt), sigma(p.sigma), 
+			twinFactor(batchExp(2.0 * p.mu * p.dt)), firstInverse(1.0 / (p.sigma * std::sqrt(p.dt))) {}
+		void step(double& plus, double& minus, double w) const
+		{
+			double factor = batchExp(mudt + sigma * w);
+			plus = plus * factor;
+			minus = minus * (twinFactor / factor);
+		}
+
+		// The factor exp(mu dt + sigma dW) is lognormal, so the density is taken in log c + log g,
+		// with df/da / f = g'/g, and is zero for g <= 0 (c > 0 as the prices are)
+		static double laneFactor(double c) { return batchLog(c); }
+		double firstDensity(double lane, double g, double logG, double gSlope) const
+		{
+			const double z = (lane + logG - mudt) * firstInverse;
+			const double density = 0.39894228040143267794 * firstInverse * batchExp(-0.5 * z * z) * gSlope / g;
+			return (g > 0.0) ? density : 0.0;
+		}
+	};
+
+	// Averaging styles, see PayoffAccumulator
+	// With every step but the first fixed, the average of a path from 1 is a function of the first step's
+	// factor alone, and the factor for which the average would be a is f = c g(a) (n = NT + 1 prices).
+	// firstCoefficient gives c from the path's average A and first price F1, firstSpot g(a) and g'(a)
+	struct EuropeanStyle
+	{
+		static void add(double& value, double S) { value = S; }
+		static double finish(double value, double /*n*/) { return value; }
+
+		// A = F1 C
+		static double firstCoefficient(double A, double F1, double /*n*/) { return F1 / A; }
+		static void firstSpot(double a, double /*n*/, double& g, double& slope)
+		{
+			g = a;
+			slope = 1.0;
+		}
+	};
+
+	struct ArithmeticStyle
+	{
+		static void add(double& value, double S) { value += S; }
+		static double finish(double value, double n) { return value / n; }
+
+		// A = (1 + F1 B)/n
+		static double firstCoefficient(double A, double F1, double n) { return F1 / (n * A - 1.0); }
+		static void firstSpot(double a, double n, double& g, double& slope)
+		{
+			g = n * a - 1.0;
+			slope = n;
+		}
+	};
+
+	struct GeometricStyle
+	{
+		static void add(double& value, double S) { value += batchLog(S); }
+		static double finish(double value, double n) { return batchExp(value / n); }
+
+		// log A = ((n - 1) log F1 + R)/n
+		static double firstCoefficient(double A, double F1, double n) { return F1 * batchExp(-n * batchLog(A) / (n - 1.0)); }
+		static void firstSpot(double a, double n, double& g, double& slope)
+		{
+			g = batchExp(n * batchLog(a) / (n - 1.0));
+			slope = g * n / ((n - 1.0) * a);
+		}
+	};
+
+	// Payoff directions
+	struct CallPayoff
+	{
+		static double apply(double S, double K) { return (S > K) ? S - K : 0.0; }
+		static double slope(double S, double K) { return (S > K) ? 1.0 : 0.0; }
+	};
+
+	struct PutPayoff
+	{
+		static double apply(double S, double K) { return (K > S) ? K - S : 0.0; }
+		static double slope(double S, double K) { return (K > S) ? -1.0 : 0.0; }
+	};
+
+	template <typename Scheme, typename Style>
+	inline void stepBatch(const Scheme& scheme, const double* w, double* plus, double* minus, double* valuePlus, double* valueMinus)
+	{
+		// One step of all the lanes, the new prices are added to the running values
+		const long L = SDE_BATCH_LANES;
+		for (long l = 0; l < L; ++l)
+		{
+			scheme.step(plus[l], minus[l], w[l]);
+			Style::add(valuePlus[l], plus[l]);
+			Style::add(valueMinus[l], minus[l]);
+		}
+	}
+
+	inline void controlBatch(const SDEBatchParameters& p, const double* w, double* logPlus, double* logMinus, double* sumPlus, double* sumMinus)
+	{
+		// One step of the log of the exact GBM path on the same increments, for the geometric control
+		const long L = SDE_BATCH_LANES;
+		const double drift = p.logDrift * p.dt;
+		for (long l = 0; l < L; ++l)
+		{
+			logPlus[l] += drift + p.sigma * w[l];
+			logMinus[l] += drift - p.sigma * w[l];
+			sumPlus[l] += logPlus[l];
+			sumMinus[l] += logMinus[l];
+		}
+	}
+
+	template <typename Scheme, typename Style, bool Control>
+	void averagesBatch(const SDEBatchParameters& p, double S, const double* dW, SDEBatchPaths& paths)
+	{
+		// Advances the lanes and folds every price into the running values straight away, 
+		// so only the current prices are held. No branches on the scheme or style inside the loops.
+		// With Control the geometric average of the exact path on the same increments is made as well
+		const long L = SDE_BATCH_LANES;
+		const Scheme scheme(p);
+		double plus[L], minus[L], valuePlus[L], valueMinus[L];
+		double logPlus[L], logMinus[L], sumPlus[L], sumMinus[L];
+		const double logS = Control ? batchLog(S) : 0.0;
+		for (long l = 0; l < L; ++l)
+		{
+			plus[l] = S;
+			minus[l] = S;
+			valuePlus[l] = 0.0;
+			valueMinus[l] = 0.0;
+			Style::add(valuePlus[l], S);
+			Style::add(valueMinus[l], S);
+			logPlus[l] = logS;
+			logMinus[l] = logS;
+			sumPlus[l] = logS;
+			sumMinus[l] = logS;
+		}
+
+		// The prices after the first step are kept for the Greeks
+		if (p.NT > 0)
+		{
+			stepBatch<Scheme, Style>(scheme, dW, plus, minus, valuePlus, valueMinus);
+			if (Control)
+				controlBatch(p, dW, logPlus, logMinus, sumPlus, sumMinus);
+		}
+		for (long l = 0; l < L; ++l)
+		{
+			paths.firstPlus[l] = plus[l];
+			paths.firstMinus[l] = minus[l];
+		}
+		for (long j = 1; j < p.NT; ++j)
+		{
+			stepBatch<Scheme, Style>(scheme, dW + j * L, plus, minus, valuePlus, valueMinus);
+			if (Control)
+				controlBatch(p, dW + j * L, logPlus, logMinus, sumPlus, sumMinus);
+		}
+
+		const double n = static_cast<double>(p.NT + 1);
+		for (long l = 0; l < L; ++l)
+		{
+			paths.averagePlus[l] = Style::finish(valuePlus[l], n);
+			paths.averageMinus[l] = Style::finish(valueMinus[l], n);
+		}
+		if (Control)
+		{
+			for (long l = 0; l < L; ++l)
+			{
+				paths.controlPlus[l] = batchExp(sumPlus[l] / n);
+				paths.controlMinus[l] = batchExp(sumMinus[l] / n);
+			}
+		}
+	}
+
+	template <typename Scheme, typename Style, typename Payoff, bool Weighted>
+	void payoffsBatch(const SDEBatchParameters& p, double S, const double* dW, double* payoffs)
+	{
+		// Mean payoff of each path and its antithetic twin. With Weighted the drift holds a shift of the
+		// Brownian motion (importance sampling) and each payoff is multiplied by the likelihood ratio of its
+		// path, exp(-shift W(T) - shift^2 T/2) with W(T) the sum of the increments (-W(T) for the twin)
+		const long L = SDE_BATCH_LANES;
+		SDEBatchPaths paths;
+		averagesBatch<Scheme, Style, false>(p, S, dW, paths);
+		if (!Weighted)
+		{
+			for (long l = 0; l < L; ++l)
+				payoffs[l] = 0.5 * (Payoff::apply(paths.averagePlus[l], p.K) + Payoff::apply(paths.averageMinus[l], p.K));
+			return;
+		}
+
+		double W[L];
+		for (long l = 0; l < L; ++l)
+			W[l] = 0.0;
+		for (long j = 0; j < p.NT; ++j)
+			for (long l = 0; l < L; ++l)
+				W[l] += dW[j * L + l];
+		const double c = -0.5 * p.shift * p.shift * static_cast<double>(p.NT) * p.dt;
+		for (long l = 0; l < L; ++l)
+			payoffs[l] = 0.5 * (Payoff::apply(paths.averagePlus[l], p.K) * batchExp(c - p.shift * W[l]) 
+				+ Payoff::apply(paths.averageMinus[l], p.K) * batchExp(c + p.shift * W[l]));
+	}
+
+	template <typename Payoff>
+	void gridBatch(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes,
+		const SDEBatchPaths& paths, const double* shift, double* sum, double* squared)
+	{
+		// The averages of GBM paths are proportional to the initial price, so the paths started
+		// at 1 give the payoffs of every spot. Unused lanes add zero
+		const long L = SDE_BATCH_LANES;
+		for (long k = 0; k < nSpots; ++k)
+		{
+			const double s = spots[k];
+			double sumK = 0.0, squaredK = 0.0;
+			for (long l = 0; l < L; ++l)
+			{
+				double payoff = 0.5 * (Payoff::apply(s * paths.averagePlus[l], p.K) + Payoff::apply(s * paths.averageMinus[l], p.K));
+				payoff = (l < lanes) ? payoff - shift[k] : 0.0;
+				sumK += payoff;
+				squaredK += payoff * payoff;
+			}
+			sum[k] += sumK;
+			squared[k] += squaredK;
+		}
+	}
+
+	template <typename Payoff>
+	void controlGridBatch(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes,
+		const SDEBatchPaths& paths, const double* controlShift, const double* payoffShift, double* controlSum, 
+		double* controlSquared, double* crossSum)
+	{
+		// As gridBatch for the payoffs of the geometric controls, and their products with the payoffs
+		const long L = SDE_BATCH_LANES;
+		for (long k = 0; k < nSpots; ++k)
+		{
+			const double s = spots[k];
+			double sumK = 0.0, squaredK = 0.0, crossK = 0.0;
+			for (long l = 0; l < L; ++l)
+			{
+				double payoff = 0.5 * (Payoff::apply(s * paths.averagePlus[l], p.K) + Payoff::apply(s * paths.averageMinus[l], p.K));
+				double control = 0.5 * (Payoff::apply(s * paths.controlPlus[l], p.K) + Payoff::apply(s * paths.controlMinus[l], p.K));
+				payoff -= payoffShift[k];
+				control = (l < lanes) ? control - controlShift[k] : 0.0;
+				sumK += control;
+				squaredK += control * control;
+				crossK += control * payoff;
+			}
+			controlSum[k] += sumK;
+			controlSquared[k] += squaredK;
+			crossSum[k] += crossK;
+		}
+	}
+
+	template <typename Scheme, typename Style, typename Payoff>
+	void greeksBatch(const SDEBatchParameters& p, const double* spots, long nSpots, long lanes, const SDEBatchPaths& paths,
+		const double* deltaShift, const double* gammaShift, double* deltaSum, double* deltaSquared, double* gammaSum, double* gammaSquared)
+	{
+		// Undiscounted delta and gamma estimators of every spot s from the paths started at 1.
+		// Delta, pathwise: d/ds f(s A) = f'(s A) A.
+		// Gamma, by conditioning on all steps but the first: E[f''(s A) A^2 | rest] = K^2/s^3 p_A(K/s | rest),
+		// the density of the average at K/s, which is the density of the first step's factor times dF1/da.
+		// Unlike the likelihood ratio of the first step it also holds for the Asian averages, which
+		// depend on s directly through the first price of the path
+		const long L = SDE_BATCH_LANES;
+		const Scheme scheme(p);
+		const double n = static_cast<double>(p.NT + 1);
+
+		// The parts of the first step's factor that depend on the path only
+		double lanePlus[L], laneMinus[L];
+		for (long l = 0; l < L; ++l)
+		{
+			lanePlus[l] = Scheme::laneFactor(Style::firstCoefficient(paths.averagePlus[l], paths.firstPlus[l], n));
+			laneMinus[l] = Scheme::laneFactor(Style::firstCoefficient(paths.averageMinus[l], paths.firstMinus[l], n));
+		}
+
+		// The spots are taken in chunks, the parts of the first step's factor that depend on the spot only
+		// are worked out for the whole chunk first
+		const long CHUNK = 64;
+		for (long first = 0; first < nSpots; first += CHUNK)
+		{
+			const long chunk = (nSpots - first < CHUNK) ? nSpots - first : CHUNK;
+			double scale[CHUNK], g[CHUNK], gSlope[CHUNK], logG[CHUNK];
+			for (long k = 0; k < chunk; ++k)
+			{
+				const double a = p.K / spots[first + k];
+				scale[k] = a * a / spots[first + k];
+				Style::firstSpot(a, n, g[k], gSlope[k]);
+				logG[k] = batchLog((g[k] > 0.0) ? g[k] : 1.0);
+			}
+
+			for (long k = 0; k < chunk; ++k)
+			{
+				const double s = spots[first + k];
+				double delta[L], gamma[L];
+				for (long l = 0; l < L; ++l)
+				{
+					delta[l] = 0.5 * (Payoff::slope(s * paths.averagePlus[l], p.K) * paths.averagePlus[l] 
+						+ Payoff::slope(s * paths.averageMinus[l], p.K) * paths.averageMinus[l]);
+					gamma[l] = 0.5 * scale[k] * (scheme.firstDensity(lanePlus[l], g[k], logG[k], gSlope[k]) 
+						+ scheme.firstDensity(laneMinus[l], g[k], logG[k], gSlope[k]));
+				}
+
+				// Unused lanes add zero
+				double deltaK = 0.0, deltaSquaredK = 0.0, gammaK = 0.0, gammaSquaredK = 0.0;
+				for (long l = 0; l < L; ++l)
+				{
+					double deltaL = (l < lanes) ? delta[l] - deltaShift[first + k] : 0.0;
+					double gammaL = (l < lanes) ? gamma[l] - gammaShift[first + k] : 0.0;
+					deltaK += deltaL;
+					deltaSquaredK += deltaL * deltaL;
+					gammaK += gammaL;
+					gammaSquaredK += gammaL * gammaL;
+				}
+				deltaSum[first + k] += deltaK;
+				deltaSquared[first + k] += deltaSquaredK;
+				gammaSum[first + k] += gammaK;
+				gammaSquared[first + k] += gammaSquaredK;
+			}
+		}
+	}
+
+	template <typename Scheme, typename Payoff>
+	SDEGreeksKernel greeksFor(int style)
+	{
+		// Instantiation for the style
+		if (style == 1)
+			return greeksBatch<Scheme, ArithmeticStyle, Payoff>;
+		else if (style == 2)
+			return greeksBatch<Scheme, GeometricStyle, Payoff>;
+		return greeksBatch<Scheme, EuropeanStyle, Payoff>;
+	}
+
+	template <typename Scheme>
+	SDEAverageKernel averagesFor(int style, bool control)
+	{
+		// Instantiation for the style, the geometric control is only made for the arithmetic average
+		if (style == 1)
+			return control ? averagesBatch<Scheme, ArithmeticStyle, true> : averagesBatch<Scheme, ArithmeticStyle, false>;
+		else if (style == 2)
+			return averagesBatch<Scheme, GeometricStyle, false>;
+		return averagesBatch<Scheme, EuropeanStyle, false>;
+	}
+
+	template <typename Scheme, typename Payoff, bool Weighted>
+	SDEPayoffKernel payoffsFor(int style)
+	{
+		// Instantiation for the style
+		if (style == 1)
+			return payoffsBatch<Scheme, ArithmeticStyle, Payoff, Weighted>;
+		else if (style == 2)
+			return payoffsBatch<Scheme, GeometricStyle, Payoff, Weighted>;
+		return payoffsBatch<Scheme, EuropeanStyle, Payoff, Weighted>;
+	}
+
+	template <typename Scheme, typename Payoff>
+	SDEPayoffKernel payoffsFor(int style, bool weighted)
+	{
+		// Instantiation for the likelihood ratio weights
+		return weighted ? payoffsFor<Scheme, Payoff, true>(style) : payoffsFor<Scheme, Payoff, false>(style);
+	}
+}
+
+SDEAverageKernel SDE_BATCH_NAME(averageKernel, KERNEL_SUFFIX)(int SDE_type, int style, bool control)
+{
+	// Picks the instantiation for the scheme, the style and the control
+	return (SDE_type == 0) ? averagesFor<EulerScheme>(style, control) : averagesFor<ExactScheme>(style, control);
+}
+
+SDEPayoffKernel SDE_BATCH_NAME(payoffKernel, KERNEL_SUFFIX)(int SDE_type, int style, char type, bool weighted)
+{
+	// Picks the instantiation for the scheme, the style, the payoff direction and the weights
+	bool call = (type == 'C' || type == 'c');
+	if (SDE_type == 0)
+		return call ? payoffsFor<EulerScheme, CallPayoff>(style, weighted) : payoffsFor<EulerScheme, PutPayoff>(style, weighted);
+	return call ? payoffsFor<ExactScheme, CallPayoff>(style, weighted) : payoffsFor<ExactScheme, PutPayoff>(style, weighted);
+}
+
+SDEGridKernel SDE_BATCH_NAME(gridKernel, KERNEL_SUFFIX)(char type)
+{
+	// Picks the instantiation for the payoff direction
+	return (type == 'C' || type == 'c') ? gridBatch<CallPayoff> : gridBatch<PutPayoff>;
+}
+
+SDEControlKernel SDE_BATCH_NAME(controlKernel, KERNEL_SUFFIX)(char type)
+{
+	// Picks the instantiation for the payoff direction
+	return (type == 'C' || type == 'c') ? controlGridBatch<CallPayoff> : controlGridBatch<PutPayoff>;
+}
+
+SDEGreeksKernel SDE_BATCH_NAME(greeksKernel, KERNEL_SUFFIX)(int SDE_type, int style, char type)
+{
+	// Picks the instantiation for the scheme, the style and the payoff direction
+	bool call = (type == 'C' || type == 'c');
+	if (SDE_type == 0)
+		return call ? greeksFor<EulerScheme, CallPayoff>(style) : greeksFor<EulerScheme, PutPayoff>(style);
+	return call ? greeksFor<ExactScheme, CallPayoff>(style) : greeksFor<ExactScheme, PutPayoff>(style);
+}
+
+#undef SDE_BATCH_NAME
+#undef SDE_BATCH_CONCAT
@@ -0,0 +1,133 @@
+#include "Sobol.hpp"
+#include "Parallel.hpp"
+#include "NormalDistribution.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Bits of every coordinate, and number of rows of the Wiener matrix handed to a thread at once
+static const int SOBOL_BITS = 32;
+static const long ROWS_PER_TASK = 256;
+
+// Rows of the Joe and Kuo table, JOE_KUO[d - 1] for dimension d
+#include "SobolDirections.inl"
+
+static uint64_t mix(uint64_t x)
+{
+	// SplitMix64 finaliser, for the digital shifts
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+Sobol::Sobol(long NT, long M, uint32_t seed, long replications) : NT(NT), M(M), replications(replications),
+	points(0), seed(seed), directions(SOBOL_BITS * NT), shifts(replications * NT), bridge(NT)
+{
+	if (replications <= 0)
+	{
+		std::stringstream os;
+		os << "Invalid number of replications (" << replications << "); must be positive.";
+		throw std::invalid_argument(os.str());
+	}
+	if (NT > SOBOL_MAX_DIMENSION)
+	{
+		std::stringstream os;
+		os << "Invalid number of time steps (" << NT << ") for quasi-random paths; must be at most " 
+			<< SOBOL_MAX_DIMENSION << ", the dimensions with Joe and Kuo direction numbers.";
+		throw std::invalid_argument(os.str());
+	}
+	this->points = (M + replications - 1) / replications;
+
+	// Dimension 0: m_k = 1, the van der Corput sequence
+	for (int b = 0; b < SOBOL_BITS && NT > 0; ++b)
+		this->directions[b * NT] = uint32_t(1) << (SOBOL_BITS - 1 - b);
+
+	// Then one primitive polynomial per dimension, x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1 with a in the 
+	// middle bits, and m_k = 2 a_1 m_(k-1) ^ 4 a_2 m_(k-2) ^ ... ^ 2^s m_(k-s) ^ m_(k-s) after the first s
+	std::vector<uint64_t> m(SOBOL_BITS + 1);
+	for (long d = 1; d < NT; ++d)
+	{
+		const uint32_t* row = JOE_KUO[d - 1];
+		int s = static_cast<int>(row[0]);
+		uint64_t a = row[1];
+		for (int k = 1; k <= s; ++k)
+			m[k] = row[k + 1];
+
+		for (int k = s + 1; k <= SOBOL_BITS; ++k)
+		{
+			uint64_t next = m[k - s] ^ (m[k - s] << s);
+			for (int i = 1; i < s; ++i)
+				if ((a >> (s - 1 - i)) & 1)
+					next ^= m[k - i] << i;
+			m[k] = next;
+		}
+		for (int b = 0; b < SOBOL_BITS; ++b)
+			this->directions[b * NT + d] = static_cast<uint32_t>(m[b + 1] << (SOBOL_BITS - 1 - b));
+	}
+
+	// Random digital shift of every replication and dimension
+	for (long r = 0; r < replications; ++r)
+		for (long d = 0; d < NT; ++d)
+			this->shifts[r * NT + d] = static_cast<uint32_t>(mix(mix(mix(seed) ^ static_cast<uint64_t>(r)) ^ static_cast<uint64_t>(d)) >> 32);
+}
+
+// Get functions
+long Sobol::getReplications() const { return this->replications; }
+long Sobol::getPointsPerReplication() const { return this->points; }
+
+long Sobol::replication(long path) const
+{
+	return (path - 1) / this->points;
+}
+
+void Sobol::generateUniforms(long n, long replication, double* U) const
+{
+	// Coordinates of point n: XOR of the direction numbers of its set bits, and the shift of the replication.
+	// Each coordinate is moved to the middle of its interval of width 2^-32, so it is never 0 or 1
+	static thread_local std::vector<uint32_t> x;
+	x.assign(this->shifts.begin() + replication * this->NT, this->shifts.begin() + (replication + 1) * this->NT);
+	uint64_t bits = static_cast<uint64_t>(n);
+	for (int b = 0; bits != 0; ++b, bits >>= 1)
+	{
+		if (!(bits & 1))
+			continue;
+		const uint32_t* v = this->directions.data() + b * this->NT;
+		for (long d = 0; d < this->NT; ++d)
+			x[d] ^= v[d];
+	}
+	const double unit = 1.0 / 4294967296.0;
+	for (long d = 0; d < this->NT; ++d)
+		U[d] = (static_cast<double>(x[d]) + 0.5) * unit;
+}
+
+void Sobol::generateWienerProcess(long path, double dt, double* dW) const
+{
+	// Uniforms of the path's point, normals, then the bridge. Paths outside 1, ..., M get zeros
+	std::fill(dW, dW + this->NT + 1, 0.0);
+	if (path < 1 || path > this->M)
+		return;
+	static thread_local std::vector<double> buffer;
+	buffer.resize(3 * this->NT);
+	double* U = buffer.data();
+	double* Z = buffer.data() + this->NT;
+	double* W = buffer.data() + 2 * this->NT;
+	long r = replication(path);
+	generateUniforms((path - 1) - r * this->points, r, U);
+	normalCDFInverse(U, this->NT, Z);
+	this->bridge.buildIncrements(Z, dt, W, dW);
+}
+
+Matrix Sobol::generateWienerProcesses(double dt, unsigned nThreads) const
+{
+	// As RNG::generateWienerProcesses, every row only depends on its own path number
+	Matrix temp_paths(this->M + 1, this->NT + 1);
+	long nTasks = (this->M + 1 + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	parallelFor(nTasks, nThreads, [&](long k)
+	{
+		long last = std::min(this->M + 1, (k + 1) * ROWS_PER_TASK);
+		for (long i = k * ROWS_PER_TASK; i < last; ++i)
+			generateWienerProcess(i, dt, temp_paths.row(i));
+	});
+	return temp_paths;
+}
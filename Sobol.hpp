@@ -0,0 +1,60 @@
+#ifndef SOBOL_HPP
+#define SOBOL_HPP
+
+// Built-in header files
+#include <vector>
+#include <cstdint>
+
+// Custom header files
+#include "Matrix.hpp"
+#include "BrownianBridge.hpp"
+
+/* ABOUT
+	- Quasi-random generator of Wiener increments, used in place of RNG for quasi-Monte Carlo
+	- Sobol points in NT dimensions, one point per path, turned into normals by the inverse normal
+	  distribution and into the increments of the path by a Brownian bridge, so the first (best 
+	  distributed) dimensions carry most of the variance of the path. For smooth payoffs the error
+	  then falls close to 1/M instead of 1/sqrt(M)
+	- The M paths are split into independent replications of the same points, each scrambled by its
+	  own random digital shift (XOR of every coordinate with a random 32 bit number). Every replication
+	  is an unbiased estimate, and the spread of the replications gives the standard error
+	- Direction numbers: the primitive polynomials and initial numbers of Joe and Kuo (2008), table
+	  new-joe-kuo-6.21201, for up to SOBOL_MAX_DIMENSION time steps, see SobolDirections.inl
+	- As RNG, each path is a pure function of (seed, path), so any path can be made on its own*/
+
+// Largest number of time steps (dimensions) with direction numbers, all the primitive polynomials up to degree 13
+const long SOBOL_MAX_DIMENSION = 1111;
+
+class Sobol
+{
+private:
+	long NT, M, replications, points;	// points: Sobol points per replication
+	uint32_t seed;
+	std::vector<uint32_t> directions;	// Direction number of bit b in dimension d, element [b * NT + d]
+	std::vector<uint32_t> shifts;		// Digital shift of replication r in dimension d, element [r * NT + d]
+	BrownianBridge bridge;
+
+public:
+	// Paths 1, ..., M in the given number of replications, path i is in replication (i - 1) / points,
+	// throws std::invalid_argument for more than SOBOL_MAX_DIMENSION time steps
+	Sobol(long NT, long M, uint32_t seed = 0, long replications = 16);
+	~Sobol() {}
+
+	// Get functions
+	long getReplications() const;
+	long getPointsPerReplication() const;
+
+	// Replication of path 1, ..., M
+	long replication(long path) const;
+
+	// Uniforms U[0], ..., U[NT - 1] in (0,1) of point n of a replication
+	void generateUniforms(long n, long replication, double* U) const;
+
+	// Wiener increments dW[0], ..., dW[NT] of a single path, dW[NT] is 0 (as RNG makes NT + 1 increments)
+	void generateWienerProcess(long path, double dt, double* dW) const;
+
+	// Wiener increments of paths 0, ..., M as a matrix, row 0 is 0
+	Matrix generateWienerProcesses(double dt, unsigned nThreads = 1) const;
+};
+
+#endif // !SOBOL_HPP
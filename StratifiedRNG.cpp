@@ -0,0 +1,72 @@
+#include "StratifiedRNG.hpp"
+#include "Parallel.hpp"
+#include "NormalDistribution.hpp"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+// Number of rows of the Wiener matrix handed to a thread at once
+static const long ROWS_PER_TASK = 256;
+
+StratifiedRNG::StratifiedRNG(long NT, long M, uint32_t seed, long strata, long run) : NT(NT), M(M), 
+	strata(strata), run(run), rng(NT, M, seed), bridge(NT)
+{
+	if (strata <= 0 || run <= 0)
+	{
+		std::stringstream os;
+		os << "Invalid number of strata (" << strata << ") or run (" << run << "); must be positive.";
+		throw std::invalid_argument(os.str());
+	}
+}
+
+// Get functions
+long StratifiedRNG::getStrata() const { return this->strata; }
+
+long StratifiedRNG::stratum(long path) const
+{
+	return ((path - 1) / this->run) % this->strata;
+}
+
+long StratifiedRNG::pathsInStratum(long stratum, long paths) const
+{
+	// Whole cycles through the strata, then what is left of the last cycle
+	long cycle = this->run * this->strata;
+	long rest = paths % cycle - stratum * this->run;
+	return (paths / cycle) * this->run + std::min(this->run, std::max(0L, rest));
+}
+
+void StratifiedRNG::generateWienerProcess(long path, double dt, double* dW) const
+{
+	// Normals of the path, the first one moved into the path's stratum, then the bridge.
+	// Paths outside 1, ..., M get zeros
+	std::fill(dW, dW + this->NT + 1, 0.0);
+	if (path < 1 || path > this->M || this->NT <= 0)
+		return;
+	static thread_local std::vector<double> buffer;
+	buffer.resize(2 * this->NT);
+	double* Z = buffer.data();
+	double* W = buffer.data() + this->NT;
+	this->rng.generateNormals(path, 0, this->NT, Z);
+
+	// The uniform is kept inside (0,1), N(Z) only rounds to 1 far out in the tail
+	const double below = std::nextafter(1.0, 0.0);
+	double U = (static_cast<double>(stratum(path)) + std::min(NormalCDF(Z[0]), below)) / static_cast<double>(this->strata);
+	Z[0] = NormalCDFInverse(std::min(U, below));
+	this->bridge.buildIncrements(Z, dt, W, dW);
+}
+
+Matrix StratifiedRNG::generateWienerProcesses(double dt, unsigned nThreads) const
+{
+	// As RNG::generateWienerProcesses, every row only depends on its own path number
+	Matrix temp_paths(this->M + 1, this->NT + 1);
+	long nTasks = (this->M + 1 + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	parallelFor(nTasks, nThreads, [&](long k)
+	{
+		long last = std::min(this->M + 1, (k + 1) * ROWS_PER_TASK);
+		for (long i = k * ROWS_PER_TASK; i < last; ++i)
+			generateWienerProcess(i, dt, temp_paths.row(i));
+	});
+	return temp_paths;
+}
@@ -0,0 +1,49 @@
+#ifndef STRATIFIED_RNG_HPP
+#define STRATIFIED_RNG_HPP
+
+// Built-in header files
+#include <cstdint>
+
+// Custom header files
+#include "RNG.hpp"
+#include "Matrix.hpp"
+#include "BrownianBridge.hpp"
+
+/* ABOUT
+	- Generator of Wiener increments with the terminal value W(T) stratified, used in place of RNG
+	- The normal distribution is cut into equally likely strata and every path is given one: the first
+	  normal of the path is moved into its stratum (U = (stratum + N(Z)) / strata, Z = N^-1(U)) and made
+	  W(T) by a Brownian bridge, which fills in the other steps from the rest of the path's normals
+	- The payoffs of European and Asian options depend mostly on W(T), so most of their variance is 
+	  between the strata and taking the same number of paths from each (proportional allocation) removes it
+	- Runs of consecutive paths share a stratum, run = SDEBatch::LANES in MonteCarlo, so a batch of paths
+	  is one stratum and the batch kernels can add up the payoffs of each stratum on its own
+	- As RNG, each path is a pure function of (seed, path)*/
+
+class StratifiedRNG
+{
+private:
+	long NT, M, strata, run;
+	RNG rng;
+	BrownianBridge bridge;
+
+public:
+	// Paths 1, ..., M, path i in stratum ((i - 1) / run) % strata
+	StratifiedRNG(long NT, long M, uint32_t seed = 0, long strata = 32, long run = 1);
+	~StratifiedRNG() {}
+
+	// Get functions
+	long getStrata() const;
+
+	// Stratum of path 1, ..., M and the number of paths 1, ..., paths in a stratum
+	long stratum(long path) const;
+	long pathsInStratum(long stratum, long paths) const;
+
+	// Wiener increments dW[0], ..., dW[NT] of a single path, dW[NT] is 0 (as RNG makes NT + 1 increments)
+	void generateWienerProcess(long path, double dt, double* dW) const;
+
+	// Wiener increments of paths 0, ..., M as a matrix, row 0 is 0
+	Matrix generateWienerProcesses(double dt, unsigned nThreads = 1) const;
+};
+
+#endif // !STRATIFIED_RNG_HPP
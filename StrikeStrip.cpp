@@ -0,0 +1,182 @@
+#include "StrikeStrip.hpp"
+#include "SDEBatch.hpp"
+#include "RNG.hpp"
+#include "Parallel.hpp"
+#include "StopWatch.cpp"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+static void sortedPairs(const std::vector<std::pair<double, double>>& pairs, double centre, std::vector<double>& keys, 
+	std::vector<double>& product, std::vector<double>& sum, bool low)
+{
+	// Key (lower or higher value) of each sorted pair and the running sums of the products and sums of the pairs,
+	// both values less centre
+	long M = static_cast<long>(pairs.size());
+	keys.resize(M);
+	product.assign(M + 1, 0.0);
+	sum.assign(M + 1, 0.0);
+	for (long i = 0; i < M; ++i)
+	{
+		keys[i] = low ? pairs[i].first : pairs[i].second;
+		double a = pairs[i].first - centre;
+		double b = pairs[i].second - centre;
+		product[i + 1] = product[i] + a * b;
+		sum[i + 1] = sum[i] + a + b;
+	}
+}
+
+StrikeStrip::StrikeStrip(const OptionData& OD, long NT, long M, int SDE_type) : myOption(OD), NT(NT), M(M), 
+	SDE_type(SDE_type), nThreads(defaultNumberOfThreads()), seed(0), time_elapsed(0.0), centre(0.0) {}
+
+// Set functions
+void StrikeStrip::setNumberOfSteps(long NT) { this->NT = NT; }
+void StrikeStrip::setNumberOfSimulations(long M) { this->M = M; }
+void StrikeStrip::setNumberOfThreads(unsigned nThreads) { this->nThreads = (nThreads == 0) ? 1 : nThreads; }
+void StrikeStrip::setSeed(uint32_t seed) { this->seed = seed; }
+
+// Get functions
+double StrikeStrip::getTimeElapsed() { return this->time_elapsed; }
+long StrikeStrip::getNumberOfSimulations() { return this->M; }
+
+void StrikeStrip::run()
+{
+	if (this->NT < 1 || this->M < 1 || this->myOption.style < 0 || this->myOption.style > 2)
+	{
+		std::stringstream os;
+		os << "Invalid strike strip (NT, M, style) = (" << this->NT << ", " << this->M << ", " << this->myOption.style << ")";
+		throw std::invalid_argument(os.str());
+	}
+	StopWatch<> sw;
+	sw.Start();
+
+	// Path i and its twin write values 2 (i - 1) and 2 (i - 1) + 1, so the blocks can run on any thread
+	long nBlocks = (this->M + SDEBatch::PATHS_PER_BLOCK - 1) / SDEBatch::PATHS_PER_BLOCK;
+	this->values.assign(2 * this->M, 0.0);
+	parallelFor(nBlocks, this->nThreads, [&](long b)
+	{
+		const long L = SDEBatch::LANES;
+		long first = 1 + b * SDEBatch::PATHS_PER_BLOCK;
+		long last = std::min(this->M, (b + 1) * SDEBatch::PATHS_PER_BLOCK);
+		SDEBatch sde(this->myOption, this->SDE_type, this->NT);
+		RNG randGen(this->NT, this->M, this->seed);
+		double dt = this->myOption.T / static_cast<double>(this->NT);
+		std::vector<double> batch_dW(this->NT * L), increments(this->NT + 1);
+		SDEBatchPaths paths;
+
+		for (long batch = first; batch <= last; batch += L)
+		{
+			// Increments of the paths in their lanes, unused lanes get zeros
+			long lanes = std::min(L, last - batch + 1);
+			SDEBatch::loadBatchIncrements(randGen, batch, lanes, this->NT, dt, batch_dW.data(), increments.data());
+
+			sde.generateAverages(this->myOption.S0, batch_dW.data(), paths);
+			for (long l = 0; l < lanes; ++l)
+			{
+				this->values[2 * (batch + l - 1)] = paths.averagePlus[l];
+				this->values[2 * (batch + l - 1) + 1] = paths.averageMinus[l];
+			}
+		}
+	});
+
+	// Mean of the values, taken off every value in the running sums
+	Accumulator all;
+	all.add(this->values.data(), 2 * this->M);
+	this->centre = all.getMean();
+
+	// Pairs (lower value, higher value) in the order of each, with their running sums
+	std::vector<std::pair<double, double>> pairs(this->M);
+	for (long i = 0; i < this->M; ++i)
+		pairs[i] = std::minmax(this->values[2 * i], this->values[2 * i + 1]);
+	std::sort(pairs.begin(), pairs.end());
+	sortedPairs(pairs, this->centre, this->lows, this->lowProduct, this->lowSum, true);
+	std::sort(pairs.begin(), pairs.end(), [](const std::pair<double, double>& a, const std::pair<double, double>& b) { return a.second < b.second; });
+	sortedPairs(pairs, this->centre, this->highs, this->highProduct, this->highSum, false);
+
+	// Sorted values and their running sums
+	std::sort(this->values.begin(), this->values.end());
+	long n = 2 * this->M;
+	this->sum.assign(n + 1, 0.0);
+	this->squared.assign(n + 1, 0.0);
+	for (long i = 0; i < n; ++i)
+	{
+		double a = this->values[i] - this->centre;
+		this->sum[i + 1] = this->sum[i] + a;
+		this->squared[i + 1] = this->squared[i] + a * a;
+	}
+
+	sw.Stop();
+	this->time_elapsed = sw.GetTime();
+}
+
+Estimate StrikeStrip::strikeEstimate(double K, char type, long i, long j) const
+{
+	// With a = A - centre and k = K - centre, the call pays a - k on the n - i values above K and the put
+	// k - a on the i values below it, and the pairs paying on both sides (a+ - k)(a- - k) = a+ a- - k (a+ + a-) + k^2.
+	// Over the c values and p pairs that pay, with the sums S of a, Q of a^2, P of a+ a- and T of a+ + a-,
+	// the mean pair payoff is +-(S - k c) / 2M and its variance, the mean of the squared pair payoffs less 
+	// the squared mean, sorted by the powers of k:
+	// ((Q + 2 P) - S^2 / M) / 4M - k (S + T - c S / M) / 2M + k^2 (c M + 2 p M - c^2) / 4M^2
+	long n = static_cast<long>(this->values.size());
+	bool call = (type == 'C' || type == 'c');
+	double k = K - this->centre;
+	double c = static_cast<double>(call ? n - i : i);
+	double S = call ? this->sum[n] - this->sum[i] : this->sum[i];
+	double Q = call ? this->squared[n] - this->squared[i] : this->squared[i];
+	double p = static_cast<double>(call ? this->M - j : j);
+	double P = call ? this->lowProduct[this->M] - this->lowProduct[j] : this->highProduct[j];
+	double T = call ? this->lowSum[this->M] - this->lowSum[j] : this->highSum[j];
+
+	double MC = static_cast<double>(this->M);
+	double mean = (call ? S - k * c : k * c - S) / (2.0 * MC);
+	double variance = ((Q + 2.0 * P) - S * S / MC) / (4.0 * MC) - k * (S + T - c * S / MC) / (2.0 * MC)
+		+ k * k * (c * MC + 2.0 * p * MC - c * c) / (4.0 * MC * MC);
+	Estimate e;
+	e.value = std::exp(-this->myOption.r * this->myOption.T) * mean;
+	e.SD = std::sqrt(std::max(variance, 0.0));
+	e.SE = e.SD / std::sqrt(MC);
+	return e;
+}
+
+Estimate StrikeStrip::price(double K, char type) const
+{
+	if (this->values.empty())
+		throw std::logic_error("Strike strip not run; call run() before pricing");
+
+	// Number of values at or below K and of pairs by binary search
+	bool call = (type == 'C' || type == 'c');
+	long i = static_cast<long>(std::upper_bound(this->values.begin(), this->values.end(), K) - this->values.begin());
+	long j = call ? static_cast<long>(std::upper_bound(this->lows.begin(), this->lows.end(), K) - this->lows.begin())
+		: static_cast<long>(std::lower_bound(this->highs.begin(), this->highs.end(), K) - this->highs.begin());
+	return strikeEstimate(K, type, i, j);
+}
+
+std::vector<Estimate> StrikeStrip::prices(const std::vector<double>& strikes, char type) const
+{
+	if (this->values.empty())
+		throw std::logic_error("Strike strip not run; call run() before pricing");
+
+	// The strikes in increasing order, then one walk up the sorted values and pairs
+	std::vector<long> order(strikes.size());
+	std::iota(order.begin(), order.end(), 0L);
+	std::sort(order.begin(), order.end(), [&](long a, long b) { return strikes[a] < strikes[b]; });
+
+	std::vector<Estimate> estimates(strikes.size());
+	bool call = (type == 'C' || type == 'c');
+	long n = static_cast<long>(this->values.size());
+	long i = 0, j = 0;
+	for (long k : order)
+	{
+		double K = strikes[k];
+		while (i < n && this->values[i] <= K)
+			++i;
+		while (call && j < this->M && this->lows[j] <= K)
+			++j;
+		while (!call && j < this->M && this->highs[j] < K)
+			++j;
+		estimates[k] = strikeEstimate(K, type, i, j);
+	}
+	return estimates;
+}
@@ -0,0 +1,73 @@
+#ifndef STRIKE_STRIP_HPP
+#define STRIKE_STRIP_HPP
+
+// Built-in header files
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+// Custom header files
+#include "OptionData.hpp"
+#include "Accumulator.hpp"
+
+/* ABOUT
+	- Prices an option at a whole strip of strikes from one simulation
+	- The paths and their antithetic twins are simulated once and only the price that goes into the
+	  payoff is kept (the last price, or the arithmetic or geometric average, as the option's style).
+	  The 2M values are sorted once, with the running sums of the values and of their squares, so the
+	  mean call payoff at K is (sum of the values above K - K (number above K)) / 2M, and the same below
+	  K for a put. A strip of strikes is then one walk through the sorted values, O(M log M + K log K) 
+	  in all, about the cost of a single price
+	- The running sums are of the values less their overall mean, and the variance is gathered in powers
+	  of K less that mean, the coefficient of the square in whole numbers, so the size of the values does
+	  not cancel against itself as it would in the mean of the squares less the square of the mean
+	- The standard error is that of the mean payoff of each pair, as in MonteCarlo. Its square needs the
+	  sum of the products of the payoffs of a path and its twin, which are both nonzero only if the lower
+	  of the two values is above K (call) or the higher is below K (put), so the pairs are sorted by their
+	  lower and higher values as well, with the running sums of A+ A- and A+ + A-
+	- Same paths as MonteCarlo with the same seed, NT and M, so the prices, SD and SE are the same up to rounding*/
+
+class StrikeStrip
+{
+private:
+	OptionData myOption;	// Dynamics and style of the strip, the strikes and types are given when pricing
+	long NT, M;
+	int SDE_type;	// 0 for Euler, 1 for exact simulation
+	unsigned nThreads;
+	uint32_t seed;
+	double time_elapsed;
+	double centre;		// Mean of the values, the sums are of the values less centre
+	std::vector<double> values;		// Payoff price of every path and its twin, in increasing order
+	std::vector<double> sum, squared;	// Sums of the first i values and of their squares, i = 0, ..., 2M
+	std::vector<double> lows, highs;	// Lower and higher value of each pair, in increasing order
+	std::vector<double> lowProduct, lowSum, highProduct, highSum;	// Sums of A+ A- and A+ + A- of the first i pairs in lows or highs
+
+	// Discounted price with i values at or below K, and j pairs with the lower value at or below K (call)
+	// or the higher value below K (put)
+	Estimate strikeEstimate(double K, char type, long i, long j) const;
+
+public:
+	// Constructor and destructors
+	StrikeStrip(const OptionData& OD, long NT, long M, int SDE_type);
+	~StrikeStrip() {}
+
+	// Set functions
+	void setNumberOfSteps(long NT);
+	void setNumberOfSimulations(long M);
+	void setNumberOfThreads(unsigned nThreads);
+	void setSeed(uint32_t seed);
+
+	// Get functions
+	double getTimeElapsed();
+	long getNumberOfSimulations();
+
+	// Main function, simulates the paths and sorts their values
+	void run();
+
+	// Discounted prices at strike K or at each of the strikes (in any order), type 'C' or 'P', 
+	// throw std::logic_error before run
+	Estimate price(double K, char type) const;
+	std::vector<Estimate> prices(const std::vector<double>& strikes, char type) const;
+};
+
+#endif // !STRIKE_STRIP_HPP
@@ -6,15 +6,18 @@
 
 // Custom header files
 #include "MonteCarlo.hpp"
+#include "Portfolio.hpp"
 #include "OptionData.hpp"
 #include "FairValue.hpp"
 #include "DataProcessing.hpp"
 
 /*	DESCRIPTION
 	- Runs the Euler and exact method for an option
-	- Plots the option's price, delta and gamma for a single stock price
+	- Plots the option's price, delta and gamma for a single stock price, the delta and gamma
+	  from the estimators of the same pass, which a grid of fewer than 3 spots uses by default
 	- Returns an accurate price of an option
-	- Prints a summary of the results*/
+	- Prints a summary of the results
+	- Then prices the six options again from one set of paths per method, see Portfolio*/
 
 int main()
 {
@@ -89,9 +92,24 @@ int main()
 			// Printing results
 			std::cout << "\t\tEuler\t\tExact\n";
 			std::cout << "Option price:\t" << MC_euler.getOptionPrice() << "\t\t" << MC_exact.getOptionPrice() << "\n";
+			std::cout << "Delta:\t\t" << MC_euler.getDeltas().at(Smin) << "\t\t" << MC_exact.getDeltas().at(Smin) << "\n";
+			std::cout << "Gamma:\t\t" << MC_euler.getGammas().at(Smin) << "\t\t" << MC_exact.getGammas().at(Smin) << "\n";
 			std::cout << "Time elapsed:\t" << MC_euler.getTimeElapsed() << "\t\t" << MC_exact.getTimeElapsed() << "\n\n";
 		}
 	}
 
+	// All six options share the underlying, so one set of paths per method prices them all
+	std::vector<OptionData> book;
+	for (int j = 0; j <= 1; j++)
+		for (style = 0; style <= 2; style++)
+			book.push_back(OptionData(Smin, K, T, r, sigma, D, type[j], style));
+	for (int SDE_type = 0; SDE_type <= 1; SDE_type++)
+	{
+		Portfolio portfolio(book, NT, M, SDE_type);
+		portfolio.run();
+		std::cout << "Portfolio, " << ((SDE_type == 0) ? "Euler" : "exact") << " method\n" << portfolio;
+		std::cout << "Time elapsed:\t" << portfolio.getTimeElapsed() << "\n\n";
+	}
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+// Built-in header files
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Custom header files
+#include "MaturityLadder.hpp"
+#include "MonteCarlo.hpp"
+#include "OptionData.hpp"
+
+/*	DESCRIPTION
+	- Prices an option at four maturities (1, 3, 6 and 12 months) from one ladder run and checks every
+	  rung against a MonteCarlo run of the option with that maturity, the same number of steps and paths
+	  and the same seed, without the control variate
+		- For European calls, arithmetic Asian puts and geometric Asian calls, Euler and exact simulation
+	- Prints the ladder and MonteCarlo prices and standard errors of each rung, which should agree up to
+	  rounding, and the time of the ladder against that of the four MonteCarlo runs*/
+
+/*int main()
+{
+	// Define variable
+	double S, K, T, r, sigma, D;
+	long NT, M;
+	std::vector<double> maturities;
+
+	// Initialise variables
+	S = 50.0;				// Stock price
+	K = 50.0;				// Strike price
+	T = 1.0;				// Maturity of the option data, the ladder uses its own maturities
+	r = 0.05;				// Constant interest rates
+	sigma = 0.25;			// Constant volatility
+	D = 0.025;				// Constant dividends
+	NT = 120;				// Number of time steps to the longest maturity
+	M = 100'000;			// Number of Monte Carlo simulations
+	maturities.push_back(1.0 / 12.0);
+	maturities.push_back(0.25);
+	maturities.push_back(0.5);
+	maturities.push_back(1.0);
+
+	std::cout << std::setprecision(10);
+	for (int style = 0; style <= 2; ++style)
+	{
+		for (int SDE_type = 0; SDE_type <= 1; ++SDE_type)
+		{
+			OptionData OD(S, K, T, r, sigma, D, (style == 1) ? 'P' : 'C', style);
+			MaturityLadder ladder(OD, maturities, NT, M, SDE_type);
+			ladder.run();
+			std::vector<Estimate> estimates = ladder.getEstimates();
+			std::vector<long> steps = ladder.getSteps();
+
+			std::cout << ((style == 0) ? "European call" : ((style == 1) ? "Arithmetic Asian put" : "Geometric Asian call"))
+				<< ", " << ((SDE_type == 0) ? "Euler" : "exact") << "\n";
+			double time = 0.0, maxError = 0.0;
+			for (std::size_t m = 0; m < maturities.size(); ++m)
+			{
+				// The option expiring at this rung, run on its own
+				OptionData rung(OD);
+				rung.T = maturities[m];
+				MonteCarlo MC(rung, S, S, 1.0, steps[m], M, 0.05, 0.01, SDE_type, style);
+				MC.setControlVariate(false);
+				MC.setStoreIncrements(false);
+				MC.run();
+				time += MC.getTimeElapsed();
+				maxError = std::max(maxError, std::abs(estimates[m].value - MC.getOptionPrice()));
+
+				std::cout << "T " << maturities[m] << ", " << steps[m] << " steps:\tladder " << estimates[m].value
+					<< " (" << estimates[m].SE << ")\tMonteCarlo " << MC.getOptionPrice() << " (" << MC.getStandardError() << ")\n";
+			}
+			std::cout << "Max price difference:\t" << maxError << "\n";
+			std::cout << "Time ladder:\t" << ladder.getTimeElapsed() << "\tMonteCarlo runs:\t" << time << "\n\n";
+		}
+	}
+	return 0;
+}*/
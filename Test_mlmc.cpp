@@ -0,0 +1,56 @@
+// Built-in header files
+#include <iostream>
+#include <vector>
+
+// Custom header files
+#include "MLMC.hpp"
+#include "OptionData.hpp"
+#include "FairValue.hpp"
+
+/*	DESCRIPTION
+	- Runs multilevel Monte Carlo for European, geometric and arithmetic Asian calls at two accuracies
+	- Prints the table of levels: time steps, paths, mean and variance of the level's samples and
+	  the cost per path in time steps
+	- Compares the price with the closed form (the European and the geometric Asian with continuous
+	  averaging, which MLMC estimates) and the total cost with that of a single level run on the
+	  finest grid with the same accuracy, the higher the ratio the more the levels save*/
+
+/*int main()
+{
+	// Define variable
+	double S, K, T, r, sigma, D;
+	long NT0;
+	std::vector<double> accuracies;
+
+	// Initialise variables
+	S = 50.0;				// Stock price
+	K = 50.0;				// Strike price
+	T = 1.0;				// Time to maturity in years
+	r = 0.05;				// Constant interest rates
+	sigma = 0.25;			// Constant volatility
+	D = 0.025;				// Constant dividends
+	NT0 = 2;				// Time steps of the coarsest level
+	accuracies.push_back(0.02);		// Target root mean square errors
+	accuracies.push_back(0.005);
+
+	for (int style = 0; style <= 2; ++style)
+	{
+		for (double accuracy : accuracies)
+		{
+			OptionData OD(S, K, T, r, sigma, D, 'C', style);
+			MLMC mlmc(OD, NT0, accuracy);
+			mlmc.run(S);
+
+			std::cout << ((style == 0) ? "European" : ((style == 1) ? "Arithmetic Asian" : "Geometric Asian")) 
+				<< " call, accuracy " << accuracy << "\n" << mlmc << "\n";
+			if (style != 1)
+			{
+				FairValue FV(OD, S, S, 1.0);
+				std::cout << "Closed form:\t" << FV.getPrice(S) << "\n";
+			}
+			std::cout << "Cost ratio:\t" << mlmc.getSingleLevelCost() / mlmc.getCost() << "\n";
+			std::cout << "Time elapsed:\t" << mlmc.getTimeElapsed() << "\n\n";
+		}
+	}
+	return 0;
+}*/
@@ -0,0 +1,73 @@
+// Built-in header files
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+// Custom header files
+#include "MonteCarlo.hpp"
+#include "OptionData.hpp"
+
+/*	DESCRIPTION
+	- Compares moment matching of the Wiener matrix with plain antithetic sampling
+		- For European and arithmetic Asian calls, Euler and exact simulation
+		- Modes 0 (none), 1 (each time step) and 2 (W(T)), see RNG::matchMoments
+	- The matched paths are not independent, so the error is measured over R runs with different
+	  seeds against a reference price from many more paths, instead of the reported standard error
+	- Prints the root mean square error, the time per run and the error^2 x time of each mode,
+	  the lower the better (the inverse of the standard error per second squared)*/
+
+/*int main()
+{
+	// Define variable
+	double K, T, r, sigma, D;
+	long NT, M, M_reference;
+	int R;
+
+	// Initialise variables
+	K = 50.0;				// Strike price (the spot is at the money)
+	T = 1.0;				// Time to maturity in years
+	r = 0.05;				// Constant interest rates
+	sigma = 0.25;			// Constant volatility
+	D = 0.025;				// Constant dividends
+	NT = 50;				// Number of time steps
+	M = 20'000;				// Number of Monte Carlo simulations per run
+	M_reference = 2'000'000;	// Number of simulations of the reference price
+	R = 40;					// Number of runs of each mode
+
+	for (int style = 0; style <= 1; ++style)
+	{
+		for (int SDE_type = 0; SDE_type <= 1; ++SDE_type)
+		{
+			OptionData OD(K, K, T, r, sigma, D, 'C', style);
+
+			// Reference price from many plain paths
+			MonteCarlo reference(OD, K, K, 1.0, NT, M_reference, 0.05, 0.01, SDE_type, style);
+			reference.setControlVariate(false);
+			reference.run();
+			double exact = reference.getOptionPrice();
+
+			std::cout << ((style == 0) ? "European" : "Arithmetic Asian") << " call, " << ((SDE_type == 0) ? "Euler" : "exact") << "\n";
+			for (int mode = 0; mode <= 2; ++mode)
+			{
+				double squaredError = 0.0, time = 0.0;
+				for (int i = 0; i < R; ++i)
+				{
+					MonteCarlo MC(OD, K, K, 1.0, NT, M, 0.05, 0.01, SDE_type, style);
+					MC.setControlVariate(false);
+					MC.setSeed(1000 + i);
+					MC.setMomentMatching(mode);
+					StopWatch<> sw;
+					sw.Start();
+					MC.run();
+					sw.Stop();
+					time += sw.GetTime();
+					double error = MC.getOptionPrice() - exact;
+					squaredError += error * error;
+				}
+				double rmse = std::sqrt(squaredError / R);
+				std::cout << "Mode " << mode << ":\tRMSE " << rmse << "\ttime " << time / R << " s\terror^2 x time " << rmse * rmse * time / R << "\n";
+			}
+		}
+	}
+	return 0;
+}*/
@@ -0,0 +1,68 @@
+// Built-in header files
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Custom header files
+#include "MonteCarlo.hpp"
+#include "RNG.hpp"
+#include "InstructionSet.hpp"
+
+/*	DESCRIPTION
+	- Microbenchmark of the normal random number generation
+	- Generates the Wiener increments of M paths of NT + 1 steps with
+		- std::mt19937 and std::normal_distribution, one number at a time
+		- RNG::generateWienerProcess, the vectorised Philox + Box-Muller kernels
+	- Prints the normals per second of both and the speedup*/
+
+/*int main()
+{
+	// Define variable
+	long NT, M;
+	double dt, sink;
+
+	// Initialise variables
+	NT = 252;			// Number of time steps
+	M = 100'000;		// Number of paths
+	dt = 1.0 / NT;		// Time step
+	sink = 0.0;			// Sum of some of the numbers, so the compiler cannot drop the work
+
+	double numbers = static_cast<double>(M) * (NT + 1);
+	std::vector<double> dW(NT + 1);
+	StopWatch<> sw;
+
+	// Standard library generator
+	std::mt19937 rd;
+	std::default_random_engine generator(rd());
+	std::normal_distribution<double> distribution(0.0, 1.0);
+	double sqrdt = std::sqrt(dt);
+	sw.Start();
+	for (long i = 0; i < M; ++i)
+	{
+		for (long j = 0; j <= NT; ++j)
+			dW[j] = sqrdt * distribution(generator);
+		sink += dW[NT];
+	}
+	sw.Stop();
+	double std_time = sw.GetTime();
+	sw.Reset();
+
+	// Counter-based generator, batch kernels
+	RNG randGen(NT, M, 1);
+	sw.Start();
+	for (long i = 0; i < M; ++i)
+	{
+		randGen.generateWienerProcess(i, dt, dW.data());
+		sink += dW[NT];
+	}
+	sw.Stop();
+	double philox_time = sw.GetTime();
+
+	// Print results
+	std::cout << "Instruction set: " << instructionSetName() << "\n";
+	std::cout << "mt19937 + normal_distribution:\t" << numbers / std_time / 1e6 << " million normals per second\n";
+	std::cout << "Philox + Box-Muller batch:\t" << numbers / philox_time / 1e6 << " million normals per second\n";
+	std::cout << "Speedup:\t\t\t" << std_time / philox_time << "\n";
+	std::cout << "(Checksum " << sink << ")\n";
+	return 0;
+}*/
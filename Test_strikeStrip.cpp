@@ -0,0 +1,77 @@
+// Built-in header files
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Custom header files
+#include "StrikeStrip.hpp"
+#include "Portfolio.hpp"
+#include "OptionData.hpp"
+
+/*	DESCRIPTION
+	- Prices calls and puts at a strip of strikes from one simulation and checks it against a Portfolio
+	  of the same options, which simulates the same paths (same seed, steps and simulations) and
+	  accumulates every payoff
+		- For European, arithmetic and geometric Asian options, exact simulation
+		- The strikes are given in decreasing order, prices() takes them in any order
+	- Prints the largest difference in price and in standard error over the strip, which should be
+	  rounding only, and the time of the strip against that of the portfolio*/
+
+/*int main()
+{
+	// Define variable
+	double S, T, r, sigma, D;
+	long NT, M, nStrikes;
+	std::vector<double> strikes;
+
+	// Initialise variables
+	S = 50.0;				// Stock price
+	T = 1.0;				// Time to maturity in years
+	r = 0.05;				// Constant interest rates
+	sigma = 0.25;			// Constant volatility
+	D = 0.025;				// Constant dividends
+	NT = 50;				// Number of time steps
+	M = 200'000;			// Number of Monte Carlo simulations
+	nStrikes = 400;			// Strikes 75 down to 25.125, each priced as a call and a put
+	for (long k = 0; k < nStrikes; ++k)
+		strikes.push_back(75.0 - 0.125 * k);
+
+	for (int style = 0; style <= 2; ++style)
+	{
+		// Strip of calls and puts
+		OptionData OD(S, S, T, r, sigma, D, 'C', style);
+		StrikeStrip strip(OD, NT, M, 1);
+		strip.run();
+		std::vector<Estimate> calls = strip.prices(strikes, 'C');
+		std::vector<Estimate> puts = strip.prices(strikes, 'P');
+
+		// The same options one by one
+		std::vector<OptionData> book;
+		for (double K : strikes)
+		{
+			book.push_back(OptionData(S, K, T, r, sigma, D, 'C', style));
+			book.push_back(OptionData(S, K, T, r, sigma, D, 'P', style));
+		}
+		Portfolio portfolio(book, NT, M, 1);
+		portfolio.run();
+		std::vector<Estimate> estimates = portfolio.getEstimates();
+
+		double priceError = 0.0, SEError = 0.0;
+		for (long k = 0; k < nStrikes; ++k)
+		{
+			priceError = std::max(priceError, std::abs(calls[k].value - estimates[2 * k].value));
+			priceError = std::max(priceError, std::abs(puts[k].value - estimates[2 * k + 1].value));
+			SEError = std::max(SEError, std::abs(calls[k].SE - estimates[2 * k].SE));
+			SEError = std::max(SEError, std::abs(puts[k].SE - estimates[2 * k + 1].SE));
+		}
+
+		std::cout << ((style == 0) ? "European" : ((style == 1) ? "Arithmetic Asian" : "Geometric Asian"))
+			<< ", " << 2 * nStrikes << " options\n";
+		std::cout << "At the money call:\t" << strip.price(S, 'C').value << " (" << strip.price(S, 'C').SE << ")\n";
+		std::cout << "Max price difference:\t" << priceError << "\n";
+		std::cout << "Max SE difference:\t" << SEError << "\n";
+		std::cout << "Time strip:\t" << strip.getTimeElapsed() << "\tportfolio:\t" << portfolio.getTimeElapsed() << "\n\n";
+	}
+	return 0;
+}*/